@@ -4,1026 +4,6264 @@
 #include <climits>
 #include <cmath>
 #include <vector>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <algorithm>
+#include <queue>
+#include <exception>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 using namespace std;
 
+//******************************************************************
+//START OF THE ASYNC CONTEXT SECTION
+//	A task started by one of the *_async functions publishes its token
+//	and progress callback here for the duration of the task. The long
+//	running loops call checkCancelled()/reportProgress(), which do
+//	nothing for ordinary synchronous calls.
+//	A loop that reports opens a ProgressScope first; only the
+//	outermost open scope publishes, so a reporting kernel nested in
+//	another one cannot rewind the task's progress.
+//******************************************************************
+
+struct AsyncContext {
+  CancellationToken token;
+  ProgressCallback progress;
+  int depth;			//ProgressScopes open on this task
+};
+
+static thread_local AsyncContext *currentAsync = nullptr;
+
+struct ProgressScope {
+  ProgressScope() {
+    if(currentAsync != nullptr) {
+      currentAsync->depth++;
+    }
+  }
+  ~ProgressScope() {
+    if(currentAsync != nullptr) {
+      currentAsync->depth--;
+    }
+  }
+};
 
 /*
-// Create a default BigInt with base 10.
+// Throw OperationCancelledException if the running task was cancelled.
 */
-BigInt::BigInt(){
-  base = 10;
-  isPositive = true;
+static void checkCancelled(){
+  if(currentAsync != nullptr && currentAsync->token.cancelled()) {
+    throw OperationCancelledException();
+  }
 }
 
 /*
-// Create a BigInt with a specified base.
+// Tell the running task's callback how far along it is, from the
+// outermost ProgressScope only.
 */
-BigInt::BigInt(int setbase){
-    if(setbase < 2 || setbase > 36){
-        throw InvalidBaseException();
-    }
-    base = setbase;
-    isPositive = true;
+static void reportProgress(double fraction){
+  if(currentAsync != nullptr && currentAsync->progress && currentAsync->depth == 1) {
+    currentAsync->progress(fraction);
+  }
 }
 
-/*
-// Destructure. 
-*/
-BigInt::~BigInt(){}
+//******************************************************************
+//END OF THE ASYNC CONTEXT SECTION
+//******************************************************************
 
-/*
-//  Create a BigInt from int (base 10).
-//  - Convert the int (base 10) input into a specified base (setbase).
-//  - Don't forget to set the base accordingly
-//  For example:
-//     BigInt k(6,2) <- int 6 base 10 to BigInt base 2
-//          - Result:  BigInt k with value 110 (base 2)
-*/
-BigInt::BigInt(int input,int setbase){
-    if(setbase < 2 || setbase > 36){
-        throw InvalidBaseException();
-    }
-  base = setbase;
-  isPositive = true;
-  int temp = input;
-  
-  if(temp < 0) {
-    isPositive = false;
-    temp *= -1;
+//******************************************************************
+//START OF THE DIGIT STORAGE SECTION
+//	DigitStore: copy-on-write digit blocks shared between BigInts.
+//******************************************************************
+
+DigitStore::DigitStore(){
+  block = NULL;
+}
+
+DigitStore::DigitStore(const DigitStore &d){
+  block = d.block;
+  if(block) {
+    block->refs.fetch_add(1, memory_order_relaxed);
   }
-  
-  if(temp == 0) {
-    vec.push_back(0);
+}
+
+DigitStore::DigitStore(DigitStore &&d){
+  block = d.block;
+  d.block = NULL;
+}
+
+DigitStore::~DigitStore(){
+  unshare();
+}
+
+DigitStore & DigitStore::operator = (const DigitStore &d){
+  if(block != d.block) {
+    if(d.block) {
+      d.block->refs.fetch_add(1, memory_order_relaxed);
+    }
+    unshare();
+    block = d.block;
   }
-  
-  while (temp != 0) {
-    vec.push_back(temp%base);
-    temp = temp/base;
+  return *this;
+}
+
+DigitStore & DigitStore::operator = (DigitStore &&d){
+  if(this != &d) {
+    unshare();
+    block = d.block;
+    d.block = NULL;
   }
+  return *this;
+}
+
+DigitStore & DigitStore::operator = (const vector<int> &d){
+  replace() = d;
+  return *this;
+}
+
+DigitStore & DigitStore::operator = (vector<int> &&d){
+  replace() = move(d);
+  return *this;
+}
+
+long DigitStore::use_count() const{
+  return block ? block->refs.load(memory_order_relaxed) : 0;
 }
 
 /*
-//  Create a BigInt from string.
-//  The input string will contain
-//      - numbers (0-9) and/or 
-//      - uppercase letters (A-Z) [A=10, B=11, ... , Z=35]
-//  The input string may contain
-//      - a negative sign ('-') to signify that the number is negative.
+//  Drop this store's reference, freeing the block with the last one.
 */
-BigInt::BigInt(const string &s, int setbase){
-    if(setbase < 2 || setbase > 36){
-        throw InvalidBaseException();
-    }
-  
-  int len = s.length();
-  int end = 0;
-  base = setbase;
-  isPositive = true;
-  
-  if(len == 0) {
-    vec.push_back(0);
-    return;
+void DigitStore::unshare(){
+  if(block && block->refs.fetch_sub(1, memory_order_acq_rel) == 1) {
+    delete block;
   }
-  
-  if(s[0] == '-') {
-    isPositive = false;
-    end++;
+  block = NULL;
+}
+
+/*
+//  Give this store a block of its own: a fresh one while empty,
+//  otherwise a deep copy of the shared one.
+*/
+void DigitStore::detach(){
+  Block *own = new Block();
+  own->refs.store(1, memory_order_relaxed);
+  if(block) {
+    own->digits = block->digits;
   }
-  
-  for(int i = len -1; i >=end; i--) {
-    if(s[i] <= 57) {
-      int dig = (int)(s[i]) - 48;
-      vec.push_back(dig);
-    }
-    
-    else {
-       int dig = (int)(s[i]) - 55;
-       vec.push_back(dig);
-    }
-  } 
+  unshare();
+  block = own;
 }
 
 /*
-//  Create a BigInt from another BigInt.
-//  This is a copy constructor.
+//  A block of its own for a caller about to overwrite every digit:
+//  a shared block is let go rather than copied.
 */
-BigInt::BigInt(const BigInt &b){  
-  *this = b;
+vector<int> & DigitStore::replace(){
+  if(!block || block->refs.load(memory_order_acquire) != 1) {
+    Block *own = new Block();
+    own->refs.store(1, memory_order_relaxed);
+    unshare();
+    block = own;
+  }
+  return block->digits;
+}
+
+const vector<int> & DigitStore::emptyDigits(){
+  static const vector<int> none;
+  return none;
 }
-  
 
 /*
-//  Assignment operator. (i.e., BigInt a = b;)
-//  Overriding a's data with BigInt b's data
-//       - vec
-//       - isPositive
-//       - base
+//  The positional members take const_iterators into the current block,
+//  which detaching would invalidate, so they go through indices.
 */
-BigInt & BigInt::operator = (const BigInt &b){
+void DigitStore::assign(const_iterator first, const_iterator last){
+  vector<int> digits(first, last);
+  replace().swap(digits);
+}
 
-  base = b.base;
-  vec = b.vec;
-  isPositive = b.isPositive;
+void DigitStore::insert(const_iterator pos, int d){
+  size_t at = pos - begin();
+  vector<int> &digits = write();
+  digits.insert(digits.begin() + at, d);
+}
 
-    return *this;
+void DigitStore::insert(const_iterator pos, size_t n, int d){
+  size_t at = pos - begin();
+  vector<int> &digits = write();
+  digits.insert(digits.begin() + at, n, d);
+}
+
+void DigitStore::erase(const_iterator first, const_iterator last){
+  size_t from = first - begin();
+  size_t to = last - begin();
+  if(block && block->refs.load(memory_order_acquire) != 1) {
+    //shared: copy only the digits that stay
+    vector<int> digits;
+    digits.reserve(size() - (to - from));
+    digits.insert(digits.end(), begin(), first);
+    digits.insert(digits.end(), last, end());
+    *this = move(digits);
+    return;
+  }
+  vector<int> &digits = write();
+  digits.erase(digits.begin() + from, digits.begin() + to);
 }
 
+/*
+//  Clearing a shared block just lets go of it.
+*/
+void DigitStore::clear(){
+  if(block && block->refs.load(memory_order_acquire) == 1) {
+    block->digits.clear();
+  }
+  else {
+    unshare();
+  }
+}
 
 //******************************************************************
-//END OF THE CONSTRUCTORS SECTION
+//END OF THE DIGIT STORAGE SECTION
 //******************************************************************
 
 //******************************************************************
-//START OF THE DISPLAYS SECTION
+//START OF THE DIGIT HELPERS SECTION
+//	Low level routines working directly on the digit vectors
+//	(least significant digit first).
 //******************************************************************
 
+//Per-base limb sizes and radix powers, cached in the BASE CONSTANTS section.
+static int mulLimbDigits(int base, int &radix);
+static int divLimbDigits(int base, uint64_t &radix);
+static const vector<int> & wordPower(int base, size_t k);
+static const vector<int> & basePower(int base, size_t k);
+
 /*
-// Convert to string and return the string
-// Display it in its corresponding base
+// Remove leading zero digits, keeping a single 0 for the value zero.
 */
-string BigInt::to_string(){
+static void trimDigits(vector<int> &d){
+  while(d.size() > 1 && d.back() == 0) {
+    d.pop_back();
+  }
+  if(d.empty()) {
+    d.push_back(0);
+  }
+}
 
-  int size = vec.size();
-  
-  string output = "";
-  
-  if(!isPositive) {
-    output += '-';
+/*
+// trimDigits for a store that may be shared: canonical digits are left
+// alone, so the block is detached only when there is something to trim.
+*/
+static void trimStore(DigitStore &d){
+  if(d.empty() || (d.size() > 1 && d.back() == 0)) {
+    trimDigits(d.write());
   }
-  
-  for(int i = size-1; i >=0; i--) {
-    if(vec[i]>=10 && vec[i]<=36) {
-      output += (char)(vec[i] +55);
-    }
-    else {
-      output += (char)(vec[i]+48);
+}
+
+/*
+// True if every digit is zero (or there are no digits at all).
+*/
+static bool isZeroDigits(const vector<int> &d){
+  for(unsigned int i = 0; i < d.size(); i++) {
+    if(d[i] != 0) {
+      return false;
     }
   }
+  return true;
+}
 
-  return output;
-   
+/*
+// Return s if base == 2^s, otherwise 0.
+*/
+static int log2Base(int base){
+  int s = 0;
+  while((1 << s) < base) {
+    s++;
+  }
+  if((1 << s) == base) {
+    return s;
+  }
+  return 0;
 }
 
 /*
-//  Convert BigInt to integer base 10 and return that int
-//    If BigInt >= INT_MAX, return INT_MAX.
-//    If BigInt =< INT_MIN, return INT_MIN.
+// Number of set bits in a machine word.
 */
-int BigInt::to_int() const{
-  
-  int result = 0;
-  int power = 0;
+static int wordPopcount(uint64_t w){
+  int count = 0;
+  while(w != 0) {
+    w &= w - 1;
+    count++;
+  }
+  return count;
+}
+
+/*
+// Number of significant bits in a machine word.
+*/
+static int wordBitLength(uint64_t w){
+  int bits = 0;
+  while(w != 0) {
+    w >>= 1;
+    bits++;
+  }
+  return bits;
+}
+
+/*
+// d = d * m + add.
+//    Multipliers up to 2^32 keep every step in 64 bits.
+*/
+static void mulSmallDigits(vector<int> &d, int base, uint64_t m, uint64_t add){
   
-  for(int i=0; i <= (int)vec.size()-1; i++) {
-    if(isPositive) {
-      result += (vec[i]*pow(base,power));
+  if(m <= ((uint64_t)1 << 32) && add <= ((uint64_t)1 << 32)) {
+    uint64_t carry = add;
+    for(unsigned int i = 0; i < d.size(); i++) {
+      uint64_t cur = (uint64_t)d[i] * m + carry;
+      d[i] = cur % base;
+      carry = cur / base;
     }
-    
-    else if(!isPositive) {
-      result -= (vec[i]*pow(base,power));
-      
-      if(result <= INT_MIN) {
-        result = INT_MIN;
-      }
+    while(carry != 0) {
+      d.push_back(carry % base);
+      carry /= base;
     }
-    power++;
   }
-  
-  if(result <= INT_MIN) {
-     return INT_MAX;
+  else {
+    unsigned __int128 carry = add;
+    for(unsigned int i = 0; i < d.size(); i++) {
+      unsigned __int128 cur = (unsigned __int128)d[i] * m + carry;
+      d[i] = cur % base;
+      carry = cur / base;
+    }
+    while(carry != 0) {
+      d.push_back(carry % base);
+      carry /= base;
+    }
   }
-  
-  return result;
+  trimDigits(d);
 }
 
-
-
-//******************************************************************
-//END OF THE DISPLAYS SECTION
-//******************************************************************
-
-//******************************************************************
-//START OF THE EQUALITY CHECK OPERATORS SECTION
-//******************************************************************
-
 /*
-//  Compare a and b.
-//     If a = b, return 0.
-//     If a < b, return -1.
-//     If a > b, return 1.
+// d = d / divisor and return d % divisor.
+//    Divisors up to 2^32 keep every step in 64 bits.
 */
-int BigInt::compare(const BigInt &b) const{
-  if(base != b.base){
-      throw DiffBaseException();
+static uint64_t divSmallDigits(vector<int> &d, int base, uint64_t divisor){
+  
+  if(divisor <= ((uint64_t)1 << 32)) {
+    uint64_t rem = 0;
+    for(int i = (int)d.size() - 1; i >= 0; i--) {
+      uint64_t cur = rem * base + d[i];
+      d[i] = cur / divisor;
+      rem = cur % divisor;
+    }
+    trimDigits(d);
+    return rem;
   }
   
-  //First compare the signs
-  if(isPositive != b.isPositive) {
-    if(b.isPositive) {
-      return -1;
+  unsigned __int128 rem = 0;
+  for(int i = (int)d.size() - 1; i >= 0; i--) {
+    unsigned __int128 cur = rem * base + d[i];
+    d[i] = cur / divisor;
+    rem = cur % divisor;
+  }
+  trimDigits(d);
+  return (uint64_t)rem;
+}
+
+/*
+// d = d + m in place. Only touches the digits the carry reaches.
+*/
+static void addSmallDigits(vector<int> &d, int base, uint64_t m){
+  for(unsigned int i = 0; m != 0; i++) {
+    if(i == d.size()) {
+      d.push_back(0);
     }
-    else {
-      return 1;
+    uint64_t cur = d[i] + m % base;
+    m /= base;
+    if(cur >= (uint64_t)base) {
+      cur -= base;
+      m++;
     }
+    d[i] = cur;
   }
+}
 
-  //If they have the same sign, compare their vec sizes 
-  
-  int sizea = vec.size();
-  int sizeb = b.vec.size();
-  
-  if(sizea != sizeb) {
-    
-    if(!isPositive) {
-      if(sizea < sizeb) {
-      return 1;
-      }
-      else {
-        return -1;
-      }
+/*
+// d = d - m in place, for d >= m.
+*/
+static void subSmallDigits(vector<int> &d, int base, uint64_t m){
+  for(unsigned int i = 0; m != 0; i++) {
+    int sub = m % base;
+    m /= base;
+    if(d[i] < sub) {
+      d[i] += base - sub;
+      m++;
     }
-   
-    else{
-      if(sizea > sizeb) {
-        return 1;
-      }
-      else {
-        return -1;
-      }
+    else {
+      d[i] -= sub;
     }
   }
-  
-  //If they have the same vec size, compare their digits one by one
-  int vala;
-  int valb;
-  int same = 0;
-  
-  for(int i = sizeb - 1; i >=0; i--) {
-    vala = vec[i];
-    valb = b.vec[i];
-    
-    if(vala != valb) {
-      if(!isPositive) {
-        
-        if(vala < valb) {
-          return 1;
-        }
-        else {
-          return -1;
-        }
-      }
-      
-      else {
-        if(vala > valb) {
-          return 1;
-        }
-        else {
-          return -1;
-        }
-      }
-    }
-    
-    else {
-      same++;
+  trimDigits(d);
+}
+
+/*
+// d = d - 1, for d > 0.
+*/
+static void decrementDigits(vector<int> &d, int base){
+  for(unsigned int i = 0; i < d.size(); i++) {
+    if(d[i] != 0) {
+      d[i]--;
+      break;
     }
+    d[i] = base - 1;
   }
-  
-  //If ALL digits are the same, then they MUST be equal!!
-  if(same == sizeb) {
-    return 0;
-  } 
-  
-  return 0;
+  trimDigits(d);
 }
 
-
-bool operator == (const BigInt &a, const BigInt &b){
-  
-  int compare = a.compare(b);
-  
-  if(compare == 0) {
-    return true;
+/*
+// Convert a native unsigned value into digits of the given base.
+*/
+static void u64ToDigits(uint64_t value, int base, vector<int> &d){
+  d.clear();
+  while(value != 0) {
+    d.push_back(value % base);
+    value /= base;
   }
-  
-  else {
-    return false;
-  } 
+  trimDigits(d);
 }
 
-bool operator != (const BigInt &a, const BigInt &b){
-
-  int compare = a.compare(b);
-  
-  if(compare != 0) {
-    return true;
-  }
-  
-  else {
-    return false;
+/*
+// Read the digits into a native unsigned value.
+//    Returns false if the value does not fit in 64 bits.
+*/
+static bool digitsToU64(const vector<int> &d, int base, uint64_t &out){
+  out = 0;
+  for(int i = (int)d.size() - 1; i >= 0; i--) {
+    if(out > (UINT64_MAX - d[i]) / base) {
+      return false;
+    }
+    out = out * base + d[i];
   }
+  return true;
 }
 
-
-bool operator <= (const BigInt &a, const BigInt &b){
-  
-  int compare = a.compare(b);
-  
-  if(compare == 1) {
-    return false;
+/*
+// Compare the value of the digits with m.
+//    Return -1, 0 or 1 like BigInt::compare.
+*/
+static int compareSmallDigits(const vector<int> &d, int base, uint64_t m){
+  uint64_t value;
+  if(!digitsToU64(d, base, value) || value > m) {
+    return 1;
   }
-  else {
-    return true;
+  if(value < m) {
+    return -1;
   }
+  return 0;
 }
 
-bool operator >= (const BigInt &a, const BigInt &b){
-  
-  int compare = a.compare(b);
-  
-  if(compare == -1) {
+/*
+// If d is base^k return true and set k.
+*/
+static bool powerOfBase(const vector<int> &d, size_t &k){
+  int top = (int)d.size() - 1;
+  while(top > 0 && d[top] == 0) {
+    top--;
+  }
+  if(top < 0 || d[top] != 1) {
     return false;
   }
-  
-  else {
-    return true;
+  for(int i = 0; i < top; i++) {
+    if(d[i] != 0) {
+      return false;
+    }
   }
+  k = top;
+  return true;
 }
 
-bool operator > (const BigInt &a, const BigInt &b){
-  
-  int compare = a.compare(b);
+/*
+// If d is 2^k return true and set k.
+//    Any power of two is recognised in power-of-two bases, otherwise
+//    only those that fit in a machine word.
+*/
+static bool powerOfTwo(const vector<int> &d, int base, size_t &k){
+  int s = log2Base(base);
   
-  if(compare == 1) {
+  if(s != 0) {
+    int top = (int)d.size() - 1;
+    while(top > 0 && d[top] == 0) {
+      top--;
+    }
+    if(top < 0 || wordPopcount(d[top]) != 1) {
+      return false;
+    }
+    for(int i = 0; i < top; i++) {
+      if(d[i] != 0) {
+        return false;
+      }
+    }
+    k = (size_t)top * s + wordBitLength(d[top]) - 1;
     return true;
   }
   
-  else {
+  uint64_t value;
+  if(!digitsToU64(d, base, value) || wordPopcount(value) != 1) {
     return false;
   }
+  k = wordBitLength(value) - 1;
+  return true;
 }
 
-//Call the compare function above to check if a < b
-bool operator < (const BigInt &a, const BigInt &b){
-  
-  int compare = a.compare(b);
-  
-  if(compare == -1) {
-    return true;
+/*
+// Two's complement negation of a fixed width word vector.
+*/
+static void negateWords(vector<uint32_t> &w){
+  uint64_t carry = 1;
+  for(unsigned int i = 0; i < w.size(); i++) {
+    uint64_t cur = (uint64_t)(uint32_t)~w[i] + carry;
+    w[i] = (uint32_t)cur;
+    carry = cur >> 32;
   }
-  
-  else {
-    return false;
+}
+
+/*
+// Limbs: k digits packed into one value of radix base^k, the largest
+// power of the base not above limit. The multiplication and division
+// kernels run on limbs so each step covers many digits.
+*/
+template<class T> static int limbDigits(int base, uint64_t limit, T &radix){
+  int k = 0;
+  uint64_t r = 1;
+  while(r * base <= limit) {
+    r *= base;
+    k++;
   }
+  radix = r;
+  return k;
 }
 
-//******************************************************************
-//END OF THE EQUALITY CHECK OPERATORS SECTION
-//******************************************************************
+template<class T> static void packLimbs(const int *d, size_t n, int base, int k, vector<T> &limbs){
+  limbs.assign((n + k - 1) / k, 0);
+  for(size_t i = 0; i < limbs.size(); i++) {
+    T limb = 0;
+    size_t end = min(n, (i + 1) * k);
+    for(size_t t = end; t-- > i * k; ) {
+      limb = limb * base + d[t];
+    }
+    limbs[i] = limb;
+  }
+}
+
+template<class T> static void unpackLimbs(const vector<T> &limbs, int base, int k, vector<int> &d){
+  d.assign(limbs.size() * k, 0);
+  for(size_t i = 0; i < limbs.size(); i++) {
+    T limb = limbs[i];
+    for(int t = 0; t < k && limb != 0; t++) {
+      d[i * k + t] = limb % base;
+      limb /= base;
+    }
+  }
+  trimDigits(d);
+}
 
 //******************************************************************
-//START OF THE ARITHMETIC OPERATORS SECTION
+//Multiplication tiers
+//	mulLimbs/sqrLimbs pick schoolbook for short operands and
+//	Karatsuba above KARATSUBA_THRESHOLD limbs; they work in any radix
+//	up to 2^27. An operand at least twice the length of the other is
+//	cut into blocks of the shorter length, so an n x m product costs
+//	about (n/m) M(m). The squaring variants compute each symmetric cross
+//	product once. mulDigits/sqrDigits pack digits into limbs around them.
 //******************************************************************
 
+//Below this many limbs schoolbook beats Karatsuba.
+static const size_t KARATSUBA_THRESHOLD = 64;
+
+//The symmetric schoolbook square does half the products, so it stays
+//ahead of Karatsuba squaring for longer.
+static const size_t SQR_KARATSUBA_THRESHOLD = 128;
+
+//Divisors and quotients both longer than this many limbs divide
+//through a Newton reciprocal, so division costs a few multiplications.
+static const size_t NEWTON_THRESHOLD = 300;
+
 /*
-//======================
-// NON-MEMBER function
-//======================
-*/ 
-BigInt operator + (const  BigInt &a, const BigInt & b){
-  BigInt c = b;
-  c += a;
-  return c;
+// d = d * base^k.
+*/
+static void shiftUpDigits(vector<int> &d, size_t k){
+  if(!isZeroDigits(d)) {
+    d.insert(d.begin(), k, 0);
+  }
 }
 
 /*
-//==================
-// MEMBER function
-//==================
+// d = d / base^k, truncated.
 */
-const BigInt & BigInt::operator += (const BigInt &b){
-    if(base != b.base){
-     
-        throw DiffBaseException();
-    }
-  
-  int carry = 0;
-  int sum = 0;
-  BigInt bvec = b;
-  BigInt avec = *this;
- 
-  
-  //zero
-  if(b.to_int() == 0) {
-    return *this;
-  }
-  if(to_int() == 0) {
-    *this = bvec;
-    return *this;
+static void shiftDownDigits(vector<int> &d, size_t k){
+  if(d.size() <= k) {
+    d.assign(1, 0);
   }
-  
-  //different signs
-  if(isPositive == true && b.isPositive == false) {
-    bvec.isPositive = true;
-    *this -= bvec;
-    return *this;
-  }
-  
-  if(isPositive == false && b.isPositive == true) {
-    avec.isPositive = true;
-    bvec -= avec;
-    *this = bvec;
-    return *this;
+  else {
+    d.erase(d.begin(), d.begin() + k);
   }
+}
+
+/*
+// Carry column sums (all non-negative) into digits.
+//    For limb radices (>= 2^12) the quotient is below 2^51, so a
+//    double reciprocal gets it to within one and a single correction
+//    replaces the 64-bit division.
+*/
+static void carryColumns(const vector<int64_t> &acc, int base, vector<int> &out){
+  out.resize(acc.size());
+  int64_t carry = 0;
   
-  //add
-  
-  unsigned int size  = max(vec.size(), b.vec.size());
-  int val;
-  int valb;
-  
-  for(int unsigned i = 0; i <size; i++) {
-    if(isPositive == b.isPositive) {
-      if(i < vec.size()) {
-        val= vec[i];
-      }
-      else {
-        val = 0;
-      }
-    
-      if(i < b.vec.size()) {
-        valb = b.vec[i];
+  if(base >= (1 << 12)) {
+    double inverse = 1.0 / base;
+    for(unsigned int i = 0; i < acc.size(); i++) {
+      int64_t cur = acc[i] + carry;
+      int64_t q = (int64_t)((double)cur * inverse);
+      int64_t r = cur - q * base;
+      if(r < 0) {
+        q--;
+        r += base;
       }
-      else {
-        valb = 0;
+      else if(r >= base) {
+        q++;
+        r -= base;
       }
-    
-      sum = val + valb + carry;
-      carry = sum / base;
-      sum = sum % base;
-
-     
-      if(i < vec.size()) {
-       vec[i] = sum;
-     }
-     else {
-       vec.push_back(sum);
-     }
+      out[i] = (int)r;
+      carry = q;
     }
   }
-  
-  //add carry to end of both same sign addition
-  if(isPositive == b.isPositive) {
-    if(carry != 0) {
-       vec.push_back(carry);
-    } 
+  else {
+    for(unsigned int i = 0; i < acc.size(); i++) {
+      int64_t cur = acc[i] + carry;
+      out[i] = cur % base;
+      carry = cur / base;
+    }
   }
-    return *this;
-  
+  while(carry != 0) {
+    out.push_back(carry % base);
+    carry /= base;
+  }
+  trimDigits(out);
 }
 
 /*
-//======================
-// NON-MEMBER function
-//======================
+// out = a * b, schoolbook. Column sums are carried once at the end.
 */
-BigInt operator - (const  BigInt &a, const BigInt & b){
+static void mulSchoolbook(const int *a, size_t na, const int *b, size_t nb, int base, vector<int> &out){
+  vector<int64_t> acc(na + nb, 0);
   
-  BigInt c(a);
-  c -= b;
-  return c;  
-
+  for(size_t i = 0; i < na; i++) {
+    int64_t ai = a[i];
+    if(ai == 0) {
+      continue;
+    }
+    int64_t *row = &acc[i];
+    for(size_t k = 0; k < nb; k++) {
+      row[k] += ai * b[k];
+    }
+  }
+  carryColumns(acc, base, out);
 }
 
 /*
-//==================
-// MEMBER function
-//==================
+// out = a * a, schoolbook.
+//    Sum a[i]*a[k] for i < k once, double it, then add the squares.
 */
-const BigInt & BigInt::operator -= (const BigInt &b){
-    if(base != b.base){
-        throw DiffBaseException();
-    }
-  
-  int difference = 0;
-  int borrow = 0;
-  BigInt bvec = b;
-  BigInt avec = *this;
+static void sqrSchoolbook(const int *a, size_t na, int base, vector<int> &out){
+  vector<int64_t> acc(2 * na, 0);
   
-  //if same vectors
-  if(vec == b.vec) {
-    if(isPositive == b.isPositive) {
-      BigInt zero;
-      zero.base = b.base;
-      zero.vec.push_back(0);
-      *this = zero;
-      return *this;
+  for(size_t i = 0; i < na; i++) {
+    int64_t ai = a[i];
+    if(ai == 0) {
+      continue;
     }
-    if(isPositive == true and b.isPositive == false) {
-      bvec.isPositive = true;
-      *this += bvec;
-      return *this;
-    }
-    if(isPositive == false and b.isPositive == true) {
-      bvec.isPositive = false;
-      *this += bvec;
-      return *this;
+    for(size_t k = i + 1; k < na; k++) {
+      acc[i+k] += ai * a[k];
     }
   }
-  
- //different signs
-  if(isPositive == true && b.isPositive == false) {
-    bvec.isPositive = true;
-    *this += bvec;
-    return *this;
+  for(size_t i = 0; i < na; i++) {
+    acc[2*i] = 2 * acc[2*i] + (int64_t)a[i] * a[i];
+    acc[2*i+1] *= 2;
   }
-  
-  if(isPositive == false && b.isPositive == true) {
-    avec.isPositive = true;
+  carryColumns(acc, base, out);
+}
+
+/*
+// out = a + b.
+*/
+static void addPieces(const int *a, size_t na, const int *b, size_t nb, int base, vector<int> &out){
+  if(na < nb) {
+    swap(a, b);
+    swap(na, nb);
+  }
+  out.resize(na + 1);
+  int carry = 0;
+  
+  for(size_t i = 0; i < na; i++) {
+    int cur = a[i] + carry;
+    if(i < nb) {
+      cur += b[i];
+    }
+    carry = 0;
+    if(cur >= base) {
+      cur -= base;
+      carry = 1;
+    }
+    out[i] = cur;
+  }
+  out[na] = carry;
+  trimDigits(out);
+}
+
+/*
+// acc += x * base^shift.
+*/
+static void addShifted(vector<int> &acc, const vector<int> &x, size_t shift, int base){
+  if(acc.size() < x.size() + shift) {
+    acc.resize(x.size() + shift, 0);
+  }
+  int carry = 0;
+  size_t i = 0;
+  
+  for(; i < x.size(); i++) {
+    int cur = acc[i+shift] + x[i] + carry;
+    carry = 0;
+    if(cur >= base) {
+      cur -= base;
+      carry = 1;
+    }
+    acc[i+shift] = cur;
+  }
+  for(i += shift; carry != 0; i++) {
+    if(i == acc.size()) {
+      acc.push_back(0);
+    }
+    int cur = acc[i] + carry;
+    carry = 0;
+    if(cur >= base) {
+      cur -= base;
+      carry = 1;
+    }
+    acc[i] = cur;
+  }
+}
+
+/*
+// acc -= x, for acc >= x.
+*/
+static void subInPlace(vector<int> &acc, const vector<int> &x, int base){
+  int borrow = 0;
+  size_t i = 0;
+  
+  for(; i < x.size(); i++) {
+    int cur = acc[i] - x[i] - borrow;
+    borrow = 0;
+    if(cur < 0) {
+      cur += base;
+      borrow = 1;
+    }
+    acc[i] = cur;
+  }
+  for(; borrow != 0; i++) {
+    int cur = acc[i] - borrow;
+    borrow = 0;
+    if(cur < 0) {
+      cur += base;
+      borrow = 1;
+    }
+    acc[i] = cur;
+  }
+  trimDigits(acc);
+}
+
+/*
+// out = a * b.
+//    Karatsuba: with a = a1*B^m + a0 and b = b1*B^m + b0,
+//    a*b = z2*B^2m + z1*B^m + z0 where z0 = a0*b0, z2 = a1*b1 and
+//    z1 = (a0+a1)(b0+b1) - z0 - z2.
+*/
+static void mulLimbs(const int *a, size_t na, const int *b, size_t nb, int base, vector<int> &out){
+  if(na < nb) {
+    swap(a, b);
+    swap(na, nb);
+  }
+  if(nb < KARATSUBA_THRESHOLD) {
+    mulSchoolbook(a, na, b, nb, base, out);
+    return;
+  }
+  checkCancelled();
+  
+  size_t m = na / 2;
+  
+  //unbalanced: slice a into equal blocks of at most nb limbs, multiply
+  //each block by b as a near-balanced product and add it into out at
+  //the block's offset
+  if(nb <= m) {
+    size_t blocks = (na + nb - 1) / nb;
+    size_t len = (na + blocks - 1) / blocks;
+    vector<int> piece;
+    out.assign(na + nb, 0);
+    for(size_t i = 0; i < na; i += len) {
+      mulLimbs(a + i, min(len, na - i), b, nb, base, piece);
+      addShifted(out, piece, i, base);
+    }
+    trimDigits(out);
+    return;
+  }
+  
+  vector<int> z0;
+  vector<int> z1;
+  vector<int> z2;
+  vector<int> suma;
+  vector<int> sumb;
+  mulLimbs(a, m, b, m, base, z0);
+  mulLimbs(a + m, na - m, b + m, nb - m, base, z2);
+  addPieces(a, m, a + m, na - m, base, suma);
+  addPieces(b, m, b + m, nb - m, base, sumb);
+  mulLimbs(suma.data(), suma.size(), sumb.data(), sumb.size(), base, z1);
+  subInPlace(z1, z0, base);
+  subInPlace(z1, z2, base);
+  
+  out.swap(z0);
+  addShifted(out, z1, m, base);
+  addShifted(out, z2, 2 * m, base);
+  trimDigits(out);
+}
+
+/*
+// out = a * a.
+//    Karatsuba squaring: three half-size squares instead of products,
+//    z1 = (a0+a1)^2 - z0 - z2.
+*/
+static void sqrLimbs(const int *a, size_t na, int base, vector<int> &out){
+  if(na < SQR_KARATSUBA_THRESHOLD) {
+    sqrSchoolbook(a, na, base, out);
+    return;
+  }
+  checkCancelled();
+  
+  size_t m = na / 2;
+  vector<int> z0;
+  vector<int> z1;
+  vector<int> z2;
+  vector<int> sum;
+  sqrLimbs(a, m, base, z0);
+  sqrLimbs(a + m, na - m, base, z2);
+  addPieces(a, m, a + m, na - m, base, sum);
+  sqrLimbs(sum.data(), sum.size(), base, z1);
+  subInPlace(z1, z0, base);
+  subInPlace(z1, z2, base);
+  
+  out.swap(z0);
+  addShifted(out, z1, m, base);
+  addShifted(out, z2, 2 * m, base);
+  trimDigits(out);
+}
+
+/*
+// out = a * b for digit vectors.
+//    The digits are packed into limbs of radix base^k <= 2^27 first, so
+//    the kernels above do k*k digit products per limb product and the
+//    column sums still fit in 64 bits.
+*/
+static void mulDigits(const int *a, size_t na, const int *b, size_t nb, int base, vector<int> &out){
+  int radix;
+  int k = mulLimbDigits(base, radix);
+  if(na + nb <= (size_t)2 * k) {
+    mulSchoolbook(a, na, b, nb, base, out);
+    return;
+  }
+  
+  vector<int> la;
+  vector<int> lb;
+  vector<int> product;
+  packLimbs(a, na, base, k, la);
+  packLimbs(b, nb, base, k, lb);
+  mulLimbs(la.data(), la.size(), lb.data(), lb.size(), radix, product);
+  unpackLimbs(product, base, k, out);
+}
+
+/*
+// out = a * a for digit vectors, packed like mulDigits.
+*/
+static void sqrDigits(const int *a, size_t na, int base, vector<int> &out){
+  int radix;
+  int k = mulLimbDigits(base, radix);
+  if(na <= (size_t)k) {
+    sqrSchoolbook(a, na, base, out);
+    return;
+  }
+  
+  vector<int> la;
+  vector<int> square;
+  packLimbs(a, na, base, k, la);
+  sqrLimbs(la.data(), la.size(), radix, square);
+  unpackLimbs(square, base, k, out);
+}
+
+/*
+// NEWTON_THRESHOLD in digits of the given base.
+*/
+static size_t newtonDigits(int base){
+  int radix;
+  return NEWTON_THRESHOLD * mulLimbDigits(base, radix);
+}
+
+/*
+// q = a / b and r = a % b for magnitudes with a >= b and b above one
+// machine word.
+//    Schoolbook long division (Knuth, Algorithm D) on packed limbs:
+//    both operands are scaled so b's top limb is at least radix/2,
+//    which makes the quotient limb estimated from the top two limbs at
+//    most one too large; a negative partial remainder then adds b back
+//    once.
+*/
+static void divDigits(const vector<int> &a, const vector<int> &b, int base, vector<int> &q, vector<int> &r){
+  uint64_t radix;
+  int k = divLimbDigits(base, radix);
+  vector<uint64_t> u;
+  vector<uint64_t> v;
+  packLimbs(a.data(), a.size(), base, k, u);
+  packLimbs(b.data(), b.size(), base, k, v);
+  while(v.size() > 1 && v.back() == 0) {
+    v.pop_back();
+  }
+  while(u.size() > v.size() && u.back() == 0) {
+    u.pop_back();
+  }
+  size_t n = v.size();
+  size_t m = u.size() - n;
+  
+  //scale so the top limb of v is at least radix/2
+  uint64_t scale = radix / (v[n-1] + 1);
+  uint64_t carry = 0;
+  for(size_t i = 0; i < n; i++) {
+    uint64_t p = v[i] * scale + carry;
+    v[i] = p % radix;
+    carry = p / radix;
+  }
+  carry = 0;
+  for(size_t i = 0; i < u.size(); i++) {
+    uint64_t p = u[i] * scale + carry;
+    u[i] = p % radix;
+    carry = p / radix;
+  }
+  u.push_back(carry);
+  vector<uint64_t> ql(m + 1, 0);
+  
+  for(size_t j = m + 1; j-- > 0; ) {
+    checkCancelled();
+    
+    //estimate the quotient limb from the top of the partial remainder
+    uint64_t top = u[j+n] * radix + u[j+n-1];
+    uint64_t qhat = top / v[n-1];
+    uint64_t rhat = top % v[n-1];
+    while(n > 1 && (qhat >= radix || qhat * v[n-2] > rhat * radix + u[j+n-2])) {
+      qhat--;
+      rhat += v[n-1];
+      if(rhat >= radix) {
+        break;
+      }
+    }
+    if(qhat >= radix) {
+      qhat = radix - 1;
+    }
+    
+    //u[j..j+n] -= qhat * v
+    uint64_t mulCarry = 0;
+    int64_t borrow = 0;
+    for(size_t i = 0; i < n; i++) {
+      uint64_t p = qhat * v[i] + mulCarry;
+      mulCarry = p / radix;
+      int64_t cur = (int64_t)u[i+j] - (int64_t)(p % radix) - borrow;
+      borrow = 0;
+      if(cur < 0) {
+        cur += radix;
+        borrow = 1;
+      }
+      u[i+j] = cur;
+    }
+    int64_t last = (int64_t)u[j+n] - (int64_t)mulCarry - borrow;
+    
+    //qhat was one too large: add v back
+    if(last < 0) {
+      qhat--;
+      uint64_t c = 0;
+      for(size_t i = 0; i < n; i++) {
+        uint64_t cur = u[i+j] + v[i] + c;
+        c = 0;
+        if(cur >= radix) {
+          cur -= radix;
+          c = 1;
+        }
+        u[i+j] = cur;
+      }
+      last += c;
+    }
+    u[j+n] = last;
+    ql[j] = qhat;
+  }
+  
+  //undo the scaling on the remainder
+  u.resize(n);
+  uint64_t rem = 0;
+  for(size_t i = n; i-- > 0; ) {
+    uint64_t cur = rem * radix + u[i];
+    u[i] = cur / scale;
+    rem = cur % scale;
+  }
+  unpackLimbs(ql, base, k, q);
+  unpackLimbs(u, base, k, r);
+}
+
+/*
+// q = a / b for magnitudes where b divides a exactly and b[0] is
+// invertible modulo the base.
+//    Exact division (Jebelean) on packed limbs: the quotient limbs come
+//    from the low end, q_j = u_j * v_0^-1 mod radix, and are never
+//    corrected. Only the low limbs that can hold the quotient matter,
+//    so each subtraction stops there. v_0^-1 is lifted from its value
+//    modulo the base by Newton steps, each doubling the digits it is
+//    correct to.
+*/
+static void divExactDigits(const vector<int> &a, const vector<int> &b, int base, vector<int> &q){
+  uint64_t radix;
+  int k = divLimbDigits(base, radix);
+  vector<uint64_t> u;
+  vector<uint64_t> v;
+  packLimbs(a.data(), a.size(), base, k, u);
+  packLimbs(b.data(), b.size(), base, k, v);
+  while(v.size() > 1 && v.back() == 0) {
+    v.pop_back();
+  }
+  while(u.size() > v.size() && u.back() == 0) {
+    u.pop_back();
+  }
+  size_t n = v.size();
+  size_t len = u.size() - n + 1;
+  u.resize(len);
+  
+  uint64_t inverse = 1;
+  while((uint64_t)b[0] * inverse % base != 1) {
+    inverse++;
+  }
+  for(int digits = 1; digits < k; digits *= 2) {
+    uint64_t t = v[0] * inverse % radix;
+    inverse = (2 + radix - t) % radix * inverse % radix;
+  }
+  
+  vector<uint64_t> ql(len, 0);
+  for(size_t j = 0; j < len; j++) {
+    checkCancelled();
+    uint64_t qj = u[j] * inverse % radix;
+    ql[j] = qj;
+    
+    //u[j..len) -= qj * v, the limb at j becoming zero
+    size_t end = min(n, len - j);
+    uint64_t *row = u.data() + j;
+    uint64_t mulCarry = 0;
+    uint64_t borrow = 0;
+    for(size_t i = 0; i < end; i++) {
+      uint64_t p = qj * v[i] + mulCarry;
+      mulCarry = p / radix;
+      uint64_t sub = p % radix + borrow;
+      borrow = row[i] < sub;
+      row[i] = row[i] + (borrow ? radix : 0) - sub;
+    }
+    mulCarry += borrow;
+    for(size_t i = end; i < len - j && mulCarry != 0; i++) {
+      borrow = row[i] < mulCarry;
+      row[i] = row[i] + (borrow ? radix : 0) - mulCarry;
+      mulCarry = borrow;
+    }
+  }
+  unpackLimbs(ql, base, k, q);
+  trimDigits(q);
+}
+
+//******************************************************************
+//Radix conversion
+//	Digits <-> 32-bit binary words. Power-of-two bases only repack
+//	bits. Other bases convert short values one word (or one limb) at a
+//	time and split long ones in half around a cached power, so the
+//	work is a few multiplications per level.
+//******************************************************************
+
+//Above this many words (or digits) the conversions split in half.
+static const size_t CONVERSION_THRESHOLD = 64;
+
+/*
+// h = d as 16-bit limbs (radix 2^16), quadratic.
+*/
+static void digitsToHalfwordsBasic(const int *d, size_t n, int base, vector<int> &h){
+  int radix;
+  size_t k = mulLimbDigits(base, radix);
+  h.assign(1, 0);
+  
+  //feed k digits at a time, most significant first
+  for(size_t i = n; i > 0; ) {
+    size_t take = min(k, i);
+    uint64_t scale = 1;
+    uint64_t chunk = 0;
+    for(size_t t = i; t-- > i - take; ) {
+      chunk = chunk * base + d[t];
+      scale *= base;
+    }
+    i -= take;
+    mulSmallDigits(h, 1 << 16, scale, chunk);
+  }
+}
+
+/*
+// h = d as 16-bit limbs: d = high * base^half + low, with base^half
+// taken from the cache as 16-bit limbs.
+*/
+static void digitsToHalfwords(const int *d, size_t n, int base, vector<int> &h){
+  if(n <= CONVERSION_THRESHOLD) {
+    digitsToHalfwordsBasic(d, n, base, h);
+    return;
+  }
+  checkCancelled();
+  
+  size_t k = 0;
+  while(((size_t)2 << k) < n) {
+    k++;
+  }
+  size_t half = (size_t)1 << k;
+  
+  vector<int> low;
+  vector<int> high;
+  digitsToHalfwords(d, half, base, low);
+  digitsToHalfwords(d + half, n - half, base, high);
+  const vector<int> &power = basePower(base, k);
+  mulLimbs(high.data(), high.size(), power.data(), power.size(), 1 << 16, h);
+  addShifted(h, low, 0, 1 << 16);
+  trimDigits(h);
+}
+
+/*
+// Convert digits into 32-bit binary words (least significant first).
+//    Zero gives an empty vector.
+*/
+static void digitsToWords(const vector<int> &d, int base, vector<uint32_t> &words){
+  words.clear();
+  int s = log2Base(base);
+  
+  if(s != 0) {
+    uint64_t acc = 0;
+    int bits = 0;
+    for(unsigned int i = 0; i < d.size(); i++) {
+      acc |= (uint64_t)d[i] << bits;
+      bits += s;
+      if(bits >= 32) {
+        words.push_back((uint32_t)acc);
+        acc >>= 32;
+        bits -= 32;
+      }
+    }
+    if(bits > 0) {
+      words.push_back((uint32_t)acc);
+    }
+  }
+  else {
+    size_t n = d.size();
+    while(n > 1 && d[n-1] == 0) {
+      n--;
+    }
+    vector<int> h;
+    digitsToHalfwords(d.data(), n, base, h);
+    for(size_t i = 0; i < h.size(); i += 2) {
+      uint32_t high = i + 1 < h.size() ? h[i+1] : 0;
+      words.push_back(high << 16 | h[i]);
+    }
+  }
+  
+  while(!words.empty() && words.back() == 0) {
+    words.pop_back();
+  }
+}
+
+/*
+// d = the n words at w, split in half around (2^32)^half from the cache.
+*/
+static void wordsToDigitsSplit(const uint32_t *w, size_t n, int base, vector<int> &d){
+  if(n <= CONVERSION_THRESHOLD) {
+    d.assign(1, 0);
+    for(size_t i = n; i-- > 0; ) {
+      mulSmallDigits(d, base, (uint64_t)1 << 32, w[i]);
+    }
+    return;
+  }
+  checkCancelled();
+  
+  size_t k = 0;
+  while(((size_t)2 << k) < n) {
+    k++;
+  }
+  size_t half = (size_t)1 << k;
+  
+  vector<int> low;
+  vector<int> high;
+  wordsToDigitsSplit(w, half, base, low);
+  wordsToDigitsSplit(w + half, n - half, base, high);
+  const vector<int> &power = wordPower(base, k);
+  mulDigits(high.data(), high.size(), power.data(), power.size(), base, d);
+  addShifted(d, low, 0, base);
+  trimDigits(d);
+}
+
+/*
+// Convert 32-bit binary words (least significant first) into digits.
+*/
+static void wordsToDigits(const vector<uint32_t> &words, int base, vector<int> &d){
+  d.clear();
+  int s = log2Base(base);
+  
+  if(s != 0) {
+    uint64_t acc = 0;
+    int bits = 0;
+    unsigned int i = 0;
+    while(i < words.size() || bits > 0) {
+      if(bits < s && i < words.size()) {
+        acc |= (uint64_t)words[i] << bits;
+        bits += 32;
+        i++;
+      }
+      d.push_back(acc & (base - 1));
+      acc >>= s;
+      bits -= s;
+    }
+    trimDigits(d);
+  }
+  else {
+    wordsToDigitsSplit(words.data(), words.size(), base, d);
+  }
+}
+
+/*
+// Smallest r with base = r^power.
+*/
+static int rootBase(int base, int &power){
+  for(int r = 2; r < base; r++) {
+    int v = r;
+    power = 1;
+    while(v < base) {
+      v *= r;
+      power++;
+    }
+    if(v == base) {
+      return r;
+    }
+  }
+  power = 1;
+  return base;
+}
+
+/*
+// Convert digits in base from into digits in base to.
+//    - Bases that are powers of one root (2, 4, 8, 16, 32 or 3, 9, 27)
+//      regroup the root digits directly, in linear time
+//    - Anything else goes through binary words, both halves divide
+//      and conquer on the cached powers
+*/
+static void convertDigits(const vector<int> &d, int from, int to, vector<int> &out){
+  int p;
+  int q;
+  int r = rootBase(from, p);
+  
+  if(from == to) {
+    out = d;
+  }
+  else if(rootBase(to, q) == r) {
+    vector<int> rootPower(q, 1);
+    for(int j = 1; j < q; j++) {
+      rootPower[j] = rootPower[j-1] * r;
+    }
+    out.assign((d.size() * p + q - 1) / q, 0);
+    size_t pos = 0;
+    for(size_t i = 0; i < d.size(); i++) {
+      int v = d[i];
+      for(int j = 0; j < p; j++, pos++) {
+        out[pos / q] += v % r * rootPower[pos % q];
+        v /= r;
+      }
+    }
+  }
+  else {
+    vector<uint32_t> words;
+    digitsToWords(d, from, words);
+    wordsToDigits(words, to, out);
+  }
+  trimDigits(out);
+}
+
+//******************************************************************
+//END OF THE DIGIT HELPERS SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE BASE CONSTANTS SECTION
+//	One BaseConstants per base, built on first use and then shared by
+//	every thread for the life of the process. Readers only load atomic
+//	pointers; a thread that loses the race to publish an entry (or the
+//	next power in a chain) deletes its own copy and uses the winner's,
+//	so nothing is ever locked or freed while readable.
+//******************************************************************
+
+//A chain of repeated squares: value, value^2, value^4, ...
+struct PowerNode {
+  vector<int> value;
+  atomic<PowerNode *> next;
+  PowerNode() : next(NULL) {}
+};
+
+struct BaseConstants {
+  BigInt zero;
+  BigInt one;
+  BigInt two;
+  int mulLimb;			//digits per multiplication limb
+  int mulRadix;			//base^mulLimb <= 2^27
+  int divLimb;			//digits per division limb
+  uint64_t divRadix;		//base^divLimb <= 2^32
+  mutable PowerNode wordPowers;	//(2^32)^(2^k) in digits of the base
+  mutable PowerNode basePowers;	//base^(2^k) in 16-bit limbs
+  explicit BaseConstants(int base);
+};
+
+static atomic<BaseConstants *> baseConstantsTable[37];
+
+BaseConstants::BaseConstants(int base) : zero(0, base), one(1, base), two(2, base){
+  mulLimb = limbDigits(base, (uint64_t)1 << 27, mulRadix);
+  divLimb = limbDigits(base, (uint64_t)1 << 32, divRadix);
+  u64ToDigits((uint64_t)1 << 32, base, wordPowers.value);
+  basePowers.value.assign(1, base);
+}
+
+static const BaseConstants & baseConstants(int base){
+  BaseConstants *c = baseConstantsTable[base].load(memory_order_acquire);
+  if(c == NULL) {
+    BaseConstants *mine = new BaseConstants(base);
+    if(baseConstantsTable[base].compare_exchange_strong(c, mine, memory_order_acq_rel, memory_order_acquire)) {
+      c = mine;
+    }
+    else {
+      delete mine;
+    }
+  }
+  return *c;
+}
+
+static int mulLimbDigits(int base, int &radix){
+  const BaseConstants &c = baseConstants(base);
+  radix = c.mulRadix;
+  return c.mulLimb;
+}
+
+static int divLimbDigits(int base, uint64_t &radix){
+  const BaseConstants &c = baseConstants(base);
+  radix = c.divRadix;
+  return c.divLimb;
+}
+
+/*
+// The k-th square of the chain starting at node, extending the chain
+// as needed. packed chains hold digits of radix (squared with
+// sqrDigits), the others hold limbs of radix (squared with sqrLimbs).
+*/
+static const vector<int> & chainPower(PowerNode *node, size_t k, int radix, bool packed){
+  for(size_t i = 0; i < k; i++) {
+    PowerNode *next = node->next.load(memory_order_acquire);
+    if(next == NULL) {
+      //owned until published, so a cancelled squaring frees it
+      unique_ptr<PowerNode> mine(new PowerNode());
+      if(packed) {
+        sqrDigits(node->value.data(), node->value.size(), radix, mine->value);
+      }
+      else {
+        sqrLimbs(node->value.data(), node->value.size(), radix, mine->value);
+      }
+      if(node->next.compare_exchange_strong(next, mine.get(), memory_order_acq_rel, memory_order_acquire)) {
+        next = mine.release();
+      }
+    }
+    node = next;
+  }
+  return node->value;
+}
+
+/*
+// (2^32)^(2^k) as digits of the base.
+*/
+static const vector<int> & wordPower(int base, size_t k){
+  return chainPower(&baseConstants(base).wordPowers, k, base, true);
+}
+
+/*
+// base^(2^k) as 16-bit limbs.
+*/
+static const vector<int> & basePower(int base, size_t k){
+  return chainPower(&baseConstants(base).basePowers, k, 1 << 16, false);
+}
+
+//******************************************************************
+//END OF THE BASE CONSTANTS SECTION
+//******************************************************************
+
+
+/*
+// Create a default BigInt with base 10.
+*/
+BigInt::BigInt(){
+  base = 10;
+  isPositive = true;
+}
+
+/*
+// Create a BigInt with a specified base.
+*/
+BigInt::BigInt(int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+    base = setbase;
+    isPositive = true;
+}
+
+/*
+// Destructure. 
+*/
+BigInt::~BigInt(){}
+
+/*
+//  Create a BigInt from int (base 10).
+//  - Convert the int (base 10) input into a specified base (setbase).
+//  - Don't forget to set the base accordingly
+//  For example:
+//     BigInt k(6,2) <- int 6 base 10 to BigInt base 2
+//          - Result:  BigInt k with value 110 (base 2)
+*/
+BigInt::BigInt(int input,int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  base = setbase;
+  setNative(nativeMagnitude(input), input < 0);
+}
+
+/*
+//  Create a BigInt from the other native integer widths.
+//  Same as the int constructor above.
+*/
+BigInt::BigInt(long input,int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  base = setbase;
+  setNative(nativeMagnitude(input), input < 0);
+}
+
+BigInt::BigInt(long long input,int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  base = setbase;
+  setNative(nativeMagnitude(input), input < 0);
+}
+
+BigInt::BigInt(unsigned int input,int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  base = setbase;
+  setNative(input, false);
+}
+
+BigInt::BigInt(unsigned long input,int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  base = setbase;
+  setNative(input, false);
+}
+
+BigInt::BigInt(unsigned long long input,int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  base = setbase;
+  setNative(input, false);
+}
+
+BigInt::BigInt(__int128 input,int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  base = setbase;
+  if(input < 0) {
+    setNative(0 - (unsigned __int128)input, true);
+  }
+  else {
+    setNative(input, false);
+  }
+}
+
+BigInt::BigInt(unsigned __int128 input,int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  base = setbase;
+  setNative(input, false);
+}
+
+/*
+//  Create a BigInt from double, dropping the fraction (truncate toward zero).
+//  - Split the double into a 53-bit integer mantissa and a power of two
+//  - Shift the mantissa by that power
+*/
+BigInt::BigInt(double input,int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+    if(std::isnan(input) || std::isinf(input)){
+        throw InvalidDoubleException();
+    }
+  base = setbase;
+  
+  int exponent;
+  double fraction = frexp(fabs(input), &exponent);
+  uint64_t mantissa = (uint64_t)ldexp(fraction, 53);
+  exponent -= 53;
+  
+  setNative(mantissa, false);
+  if(exponent > 0) {
+    *this <<= exponent;
+  }
+  else {
+    *this >>= -exponent;
+  }
+  isPositive = input >= 0 || is_zero();
+}
+
+/*
+//  Set the digits from a native magnitude and sign.
+*/
+void BigInt::setNative(unsigned __int128 mag, bool negative){
+  vec.clear();
+  isPositive = !negative || mag == 0;
+  
+  if(mag == 0) {
+    vec.push_back(0);
+  }
+  
+  while (mag != 0) {
+    vec.push_back(mag%base);
+    mag = mag/base;
+  }
+}
+
+/*
+//  Create a BigInt from string.
+//  The input string will contain
+//      - numbers (0-9) and/or 
+//      - uppercase letters (A-Z) [A=10, B=11, ... , Z=35]
+//  The input string may contain
+//      - a negative sign ('-') to signify that the number is negative.
+*/
+BigInt::BigInt(const string &s, int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  
+  int len = s.length();
+  int end = 0;
+  base = setbase;
+  isPositive = true;
+  
+  if(len == 0) {
+    vec.push_back(0);
+    return;
+  }
+  
+  if(s[0] == '-') {
+    isPositive = false;
+    end++;
+  }
+  
+  for(int i = len -1; i >=end; i--) {
+    if(s[i] <= 57) {
+      int dig = (int)(s[i]) - 48;
+      vec.push_back(dig);
+    }
+    
+    else {
+       int dig = (int)(s[i]) - 55;
+       vec.push_back(dig);
+    }
+  } 
+  
+  //drop leading zeros so is_zero() and compare() can trust the size
+  trimDigits(vec.write());
+  if(is_zero()) {
+    isPositive = true;
+  }
+}
+
+/*
+//  Create a BigInt from another BigInt.
+//  This is a copy constructor.
+*/
+BigInt::BigInt(const BigInt &b){  
+  *this = b;
+}
+  
+
+/*
+//  Assignment operator. (i.e., BigInt a = b;)
+//  Overriding a's data with BigInt b's data
+//       - vec (shared with b until either one is modified)
+//       - isPositive
+//       - base
+*/
+BigInt & BigInt::operator = (const BigInt &b){
+
+  base = b.base;
+  vec = b.vec;
+  isPositive = b.isPositive;
+
+    return *this;
+}
+
+/*
+//  Create a BigInt holding b's value in another base.
+*/
+BigInt::BigInt(const BigInt &b, int newbase){
+    if(newbase < 2 || newbase > 36){
+        throw InvalidBaseException();
+    }
+  base = newbase;
+  isPositive = b.isPositive;
+  if(b.base == newbase) {
+    vec = b.vec;
+  }
+  else {
+    vector<int> d;
+    convertDigits(b.vec, b.base, newbase, d);
+    vec = d;
+  }
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+*/
+const BigInt & BigInt::change_base(int newbase){
+  if(newbase != base) {
+    *this = BigInt(*this, newbase);
+  }
+  return *this;
+}
+
+//Off by default: operands of different bases throw DiffBaseException.
+static atomic<bool> autoConvertMode(false);
+
+void BigInt::set_auto_convert(bool enable){
+  autoConvertMode.store(enable);
+}
+
+bool BigInt::auto_convert(){
+  return autoConvertMode.load(memory_order_relaxed);
+}
+
+/*
+// b in the given base for a mixed-base operation: converted when
+// automatic conversion is on, DiffBaseException otherwise.
+*/
+static BigInt mixedBase(const BigInt &b, int base){
+  if(!BigInt::auto_convert()) {
+    throw DiffBaseException();
+  }
+  return BigInt(b, base);
+}
+
+
+//******************************************************************
+//END OF THE CONSTRUCTORS SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE DISPLAYS SECTION
+//******************************************************************
+
+/*
+// Convert to string and return the string
+// Display it in its corresponding base
+*/
+string BigInt::to_string() const{
+
+  int size = vec.size();
+  
+  string output = "";
+  
+  if(size == 0) {
+    return "0";
+  }
+  
+  if(!isPositive) {
+    output += '-';
+  }
+  
+  for(int i = size-1; i >=0; i--) {
+    if(vec[i]>=10 && vec[i]<=36) {
+      output += (char)(vec[i] +55);
+    }
+    else {
+      output += (char)(vec[i]+48);
+    }
+  }
+
+  return output;
+   
+}
+
+/*
+//  Convert BigInt to integer base 10 and return that int
+//    If BigInt >= INT_MAX, return INT_MAX.
+//    If BigInt =< INT_MIN, return INT_MIN.
+*/
+int BigInt::to_int() const{
+  
+  if(fits_in<int>()) {
+    return (int)to_int64();
+  }
+  
+  if(isPositive) {
+    return INT_MAX;
+  }
+  return INT_MIN;
+}
+
+/*
+//  Return the base the digits are stored in.
+*/
+int BigInt::get_base() const{
+  return base;
+}
+
+size_t BigInt::size() const{
+  return vec.empty() ? 1 : vec.size();
+}
+
+/*
+//  Read the magnitude into a 128-bit value, most significant digit first.
+//    Returns false as soon as it no longer fits.
+*/
+bool BigInt::magnitude128(unsigned __int128 &out) const{
+  unsigned __int128 limit = ~(unsigned __int128)0;
+  out = 0;
+  
+  for(int i = (int)vec.size() - 1; i >= 0; i--) {
+    if(out > (limit - vec[i]) / base) {
+      return false;
+    }
+    out = out * base + vec[i];
+  }
+  return true;
+}
+
+/*
+//  Does the value fit in an integer type of the given width?
+*/
+bool BigInt::fitsBits(int bits, bool isSigned) const{
+  unsigned __int128 mag;
+  if(!magnitude128(mag)) {
+    return false;
+  }
+  
+  int valueBits = bits - (isSigned ? 1 : 0);
+  unsigned __int128 maxPositive = ~(unsigned __int128)0 >> (128 - valueBits);
+  
+  if(isPositive || mag == 0) {
+    return mag <= maxPositive;
+  }
+  return isSigned && mag <= maxPositive + 1;
+}
+
+/*
+//  Does the value round to a finite floating point number with the
+//  given mantissa digits and maximum exponent?
+//    Anything below (2^(digits+1) - 1) * 2^(maxExponent-digits-1) rounds
+//    to at most the largest finite value.
+*/
+bool BigInt::fitsFloating(int digits, int maxExponent) const{
+  size_t bits = bit_length();
+  
+  if(bits < (size_t)maxExponent) {
+    return true;
+  }
+  if(bits > (size_t)maxExponent) {
+    return false;
+  }
+  
+  BigInt limit(1, base);
+  limit <<= digits + 1;
+  limit -= 1;
+  limit <<= maxExponent - digits - 1;
+  
+  BigInt mag(*this);
+  mag.isPositive = true;
+  return mag < limit;
+}
+
+/*
+//  Convert to int64_t.
+*/
+int64_t BigInt::to_int64() const{
+    if(!fits_in<int64_t>()){
+        throw NativeOverflowException();
+    }
+  
+  unsigned __int128 mag;
+  magnitude128(mag);
+  if(isPositive) {
+    return (int64_t)mag;
+  }
+  return (int64_t)(0 - (uint64_t)mag);
+}
+
+/*
+//  Convert to uint64_t.
+*/
+uint64_t BigInt::to_uint64() const{
+    if(!fits_in<uint64_t>()){
+        throw NativeOverflowException();
+    }
+  
+  unsigned __int128 mag;
+  magnitude128(mag);
+  return (uint64_t)mag;
+}
+
+/*
+//  Convert to __int128.
+*/
+__int128 BigInt::to_int128() const{
+    if(!fits_in<__int128>()){
+        throw NativeOverflowException();
+    }
+  
+  unsigned __int128 mag;
+  magnitude128(mag);
+  if(isPositive) {
+    return (__int128)mag;
+  }
+  return (__int128)(0 - mag);
+}
+
+/*
+//  Convert to double, correctly rounded (round half to even).
+//    - Up to 64 bits the hardware conversion already rounds correctly
+//    - Otherwise take the top 64 bits, round them to 53 by hand using
+//      the bits below as a sticky bit, and scale with ldexp
+//    Values too large for double become infinity.
+*/
+double BigInt::to_double() const{
+  unsigned __int128 small;
+  double result;
+  
+  if(magnitude128(small) && (small >> 64) == 0) {
+    result = (double)(uint64_t)small;
+  }
+  else {
+    vector<uint32_t> words;
+    digitsToWords(vec, base, words);
+    
+    size_t bits = (words.size() - 1) * 32 + wordBitLength(words.back());
+    size_t shift = bits - 64;
+    size_t w = shift / 32;
+    int offset = shift % 32;
+    
+    //top 64 bits
+    unsigned __int128 window = 0;
+    for(size_t i = 0; i < 3 && w + i < words.size(); i++) {
+      window |= (unsigned __int128)words[w + i] << (32 * i);
+    }
+    uint64_t top = (uint64_t)(window >> offset);
+    
+    //sticky bit: anything nonzero below the top 64 bits
+    bool sticky = (words[w] & (((uint64_t)1 << offset) - 1)) != 0;
+    for(size_t i = 0; i < w && !sticky; i++) {
+      sticky = words[i] != 0;
+    }
+    
+    uint64_t mantissa = top >> 11;
+    uint64_t rest = top & 0x7FF;
+    if(rest > 0x400 || (rest == 0x400 && (sticky || (mantissa & 1)))) {
+      mantissa++;
+    }
+    result = ldexp((double)mantissa, shift + 11);
+  }
+  
+  if(isPositive) {
+    return result;
+  }
+  return -result;
+}
+
+/*
+//  O(1) queries. The digits never carry leading zeros, so zero is
+//  either no digits or a single 0.
+*/
+bool BigInt::is_zero() const{
+  return vec.empty() || (vec.size() == 1 && vec[0] == 0);
+}
+
+bool BigInt::is_one() const{
+  return isPositive && vec.size() == 1 && vec[0] == 1;
+}
+
+int BigInt::sign() const{
+  if(is_zero()) {
+    return 0;
+  }
+  if(isPositive) {
+    return 1;
+  }
+  return -1;
+}
+
+//******************************************************************
+//END OF THE DISPLAYS SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE EQUALITY CHECK OPERATORS SECTION
+//******************************************************************
+
+/*
+//  Compare a and b.
+//     If a = b, return 0.
+//     If a < b, return -1.
+//     If a > b, return 1.
+*/
+int BigInt::compare(const BigInt &b) const{
+  if(base != b.base){
+      return compare(mixedBase(b, base));
+  }
+  
+  //First compare the signs
+  if(isPositive != b.isPositive) {
+    if(b.isPositive) {
+      return -1;
+    }
+    else {
+      return 1;
+    }
+  }
+
+  //If they have the same sign, compare their vec sizes 
+  
+  int sizea = vec.size();
+  int sizeb = b.vec.size();
+  
+  if(sizea != sizeb) {
+    
+    if(!isPositive) {
+      if(sizea < sizeb) {
+      return 1;
+      }
+      else {
+        return -1;
+      }
+    }
+   
+    else{
+      if(sizea > sizeb) {
+        return 1;
+      }
+      else {
+        return -1;
+      }
+    }
+  }
+  
+  //If they have the same vec size, compare their digits one by one
+  int vala;
+  int valb;
+  int same = 0;
+  
+  for(int i = sizeb - 1; i >=0; i--) {
+    vala = vec[i];
+    valb = b.vec[i];
+    
+    if(vala != valb) {
+      if(!isPositive) {
+        
+        if(vala < valb) {
+          return 1;
+        }
+        else {
+          return -1;
+        }
+      }
+      
+      else {
+        if(vala > valb) {
+          return 1;
+        }
+        else {
+          return -1;
+        }
+      }
+    }
+    
+    else {
+      same++;
+    }
+  }
+  
+  //If ALL digits are the same, then they MUST be equal!!
+  if(same == sizeb) {
+    return 0;
+  } 
+  
+  return 0;
+}
+
+
+bool operator == (const BigInt &a, const BigInt &b){
+  
+  int compare = a.compare(b);
+  
+  if(compare == 0) {
+    return true;
+  }
+  
+  else {
+    return false;
+  } 
+}
+
+bool operator != (const BigInt &a, const BigInt &b){
+
+  int compare = a.compare(b);
+  
+  if(compare != 0) {
+    return true;
+  }
+  
+  else {
+    return false;
+  }
+}
+
+
+bool operator <= (const BigInt &a, const BigInt &b){
+  
+  int compare = a.compare(b);
+  
+  if(compare == 1) {
+    return false;
+  }
+  else {
+    return true;
+  }
+}
+
+bool operator >= (const BigInt &a, const BigInt &b){
+  
+  int compare = a.compare(b);
+  
+  if(compare == -1) {
+    return false;
+  }
+  
+  else {
+    return true;
+  }
+}
+
+bool operator > (const BigInt &a, const BigInt &b){
+  
+  int compare = a.compare(b);
+  
+  if(compare == 1) {
+    return true;
+  }
+  
+  else {
+    return false;
+  }
+}
+
+//Call the compare function above to check if a < b
+bool operator < (const BigInt &a, const BigInt &b){
+  
+  int compare = a.compare(b);
+  
+  if(compare == -1) {
+    return true;
+  }
+  
+  else {
+    return false;
+  }
+}
+
+//******************************************************************
+//END OF THE EQUALITY CHECK OPERATORS SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE ARITHMETIC OPERATORS SECTION
+//******************************************************************
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/ 
+BigInt operator + (const  BigInt &a, const BigInt & b){
+  BigInt c = a;
+  c += b;
+  return c;
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+*/
+const BigInt & BigInt::operator += (const BigInt &b){
+    if(base != b.base){
+        return *this += mixedBase(b, base);
+    }
+  
+  int carry = 0;
+  int sum = 0;
+ 
+  
+  //zero
+  if(b.is_zero()) {
+    return *this;
+  }
+  if(is_zero()) {
+    *this = b;
+    return *this;
+  }
+  
+  //different signs
+  //(the copies share digits with b and *this until modified)
+  if(isPositive == true && b.isPositive == false) {
+    BigInt bvec = b;
+    bvec.isPositive = true;
+    *this -= bvec;
+    return *this;
+  }
+  
+  if(isPositive == false && b.isPositive == true) {
+    BigInt bvec = b;
+    BigInt avec = *this;
+    avec.isPositive = true;
+    bvec -= avec;
+    *this = bvec;
+    return *this;
+  }
+  
+  //add
+  
+  unsigned int size  = max(vec.size(), b.vec.size());
+  int val;
+  int valb;
+  
+  for(int unsigned i = 0; i <size; i++) {
+    if(isPositive == b.isPositive) {
+      if(i < vec.size()) {
+        val= vec[i];
+      }
+      else {
+        val = 0;
+      }
+    
+      if(i < b.vec.size()) {
+        valb = b.vec[i];
+      }
+      else {
+        valb = 0;
+      }
+    
+      sum = val + valb + carry;
+      carry = sum / base;
+      sum = sum % base;
+
+     
+      if(i < vec.size()) {
+       vec.write()[i] = sum;
+     }
+     else {
+       vec.push_back(sum);
+     }
+    }
+  }
+  
+  //add carry to end of both same sign addition
+  if(isPositive == b.isPositive) {
+    if(carry != 0) {
+       vec.push_back(carry);
+    } 
+  }
+    return *this;
+  
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt operator - (const  BigInt &a, const BigInt & b){
+  
+  BigInt c(a);
+  c -= b;
+  return c;  
+
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+*/
+const BigInt & BigInt::operator -= (const BigInt &b){
+    if(base != b.base){
+        return *this -= mixedBase(b, base);
+    }
+  
+  int difference = 0;
+  int borrow = 0;
+  
+  //if same vectors
+  //(the copies share digits with b and *this until modified)
+  if(vec == b.vec) {
+    if(isPositive == b.isPositive) {
+      *this = baseConstants(base).zero;
+      return *this;
+    }
+    BigInt bvec = b;
+    bvec.isPositive = isPositive;
+    *this += bvec;
+    return *this;
+  }
+  
+ //different signs
+  if(isPositive == true && b.isPositive == false) {
+    BigInt bvec = b;
+    bvec.isPositive = true;
+    *this += bvec;
+    return *this;
+  }
+  
+  if(isPositive == false && b.isPositive == true) {
+    BigInt bvec = b;
+    BigInt avec = *this;
+    avec.isPositive = true;
     bvec += avec;
     bvec.isPositive = false;
     *this = bvec;
     return *this;
   }
-   
-  //subtract
-  if((isPositive && (*this) < b)) {
-    avec = b - *this;
-    *this = avec;
-    isPositive = false;
-    return *this;
+   
+  //subtract
+  if((isPositive && (*this) < b)) {
+    *this = b - *this;
+    isPositive = false;
+    return *this;
+  }
+  
+  if((!isPositive && (*this) > b)) {
+    *this = b - *this;
+    isPositive = true;
+    return *this;
+  }
+    
+  unsigned int size  = max(vec.size(), b.vec.size());
+  int val;
+  int valb;
+  
+  for(unsigned int i = 0; i < size; i++) {
+    
+    if(i < vec.size()) {
+      val = vec[i];
+    }
+    else {
+      val = 0;
+    }
+    
+    if(i < b.vec.size()) {
+      valb = b.vec[i];
+    }
+    else {
+      valb = 0;
+    }
+    
+    difference = val - valb - borrow;
+    borrow = 0;
+    if(difference < 0) {
+      difference += base;
+      borrow++;
+    }
+    
+    if(i < vec.size()) {
+       vec.write()[i] = difference;
+     }
+     else {
+       vec.push_back(difference);
+     }
+  }
+  
+  //remove all leading zeros
+  for(int i = vec.size()-1; i >= 0; i--) {
+    if(vec[i] == 0) {
+      vec.pop_back();
+  }
+    else {
+      break;
+    }
+  }
+  
+  return *this;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt operator * (const  BigInt &a, const BigInt & b){
+
+  BigInt c(a);
+  c *= b;
+  return c;
+
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+*/
+const BigInt & BigInt::operator *= (const BigInt &b){
+    if(base != b.base){
+        return *this *= mixedBase(b, base);
+    }
+
+  //zero
+  if(b.is_zero()) {
+    *this = b;
+    return *this;
+  }
+  if(is_zero()) {
+    return *this;
+  }
+  
+  //one
+  if(b.is_one()) {
+    return *this;
+  }
+  if(is_one()) {
+    *this = b;
+    return *this;
+  }
+  
+  //is result negative
+  bool neg = isPositive == b.isPositive;
+  
+  //power of the base: shift digits instead of multiplying
+  size_t k;
+  if(powerOfBase(b.vec, k)) {
+    trimDigits(vec.write());
+    vec.insert(vec.begin(), k, 0);
+    isPositive = neg;
+    return *this;
+  }
+  if(powerOfBase(vec, k)) {
+    vector<int> shifted(b.vec);
+    trimDigits(shifted);
+    shifted.insert(shifted.begin(), k, 0);
+    vec = shifted;
+    isPositive = neg;
+    return *this;
+  }
+  
+  //power of two: shift bits instead of multiplying
+  if(powerOfTwo(b.vec, base, k)) {
+    *this <<= k;
+    isPositive = neg;
+    return *this;
+  }
+
+  //a *= a squares: each cross product is only computed once
+  vector<int> result;
+  if(&b == this) {
+    sqrDigits(vec.data(), vec.size(), base, result);
+  }
+  else {
+    mulDigits(vec.data(), vec.size(), b.vec.data(), b.vec.size(), base, result);
+  }
+
+  vec = move(result);
+  this->isPositive = neg;
+  
+  return *this;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt square(const BigInt &a){
+
+  BigInt c(a);
+  c.square();
+  return c;
+
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+//  Square in place. Same as *this *= *this.
+*/
+const BigInt & BigInt::square(){
+  *this *= *this;
+  return *this;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt operator / (const  BigInt &a, const BigInt & b){
+   
+  BigInt c = a;
+  c /= b;
+  
+  return c;
+}
+
+
+/*
+//==================
+// MEMBER function
+//==================
+*/
+const BigInt & BigInt::operator /= (const BigInt &b){
+    if(base != b.base){
+        return *this /= mixedBase(b, base);
+    }
+    if(b.is_zero()){
+        throw DivByZeroException();
+    }
+    
+  BigInt q;
+  BigInt r;
+  
+  q.base = base;
+  r.base = base;
+    
+  divisionMain(b, q, r);
+  *this = q;
+ 
+  return *this;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt operator % (const  BigInt &a, const BigInt & b){
+  
+  BigInt c = a;
+  c %= b;
+  return c;
+
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+*/
+const BigInt & BigInt::operator %= (const BigInt &b){
+    if(base != b.base){
+        return *this %= mixedBase(b, base);
+    }
+    if(b.is_zero()){
+        throw DivByZeroException();//divide by zero.
+    }
+
+  BigInt q;
+  BigInt r;
+  
+  q.base = base;
+  r.base = base;
+    
+  divisionMain(b, q, r);
+  *this = r;
+  return *this;
+  
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+//  Quotient and remainder from a single divisionMain call.
+*/
+pair<BigInt, BigInt> divmod(const BigInt &a, const BigInt &b){
+    if(a.base != b.base){
+        return divmod(a, mixedBase(b, a.base));
+    }
+    if(b.is_zero()){
+        throw DivByZeroException();
+    }
+  
+  BigInt q;
+  BigInt r;
+  
+  q.base = a.base;
+  r.base = a.base;
+  
+  BigInt dividend(a);
+  dividend.divisionMain(b, q, r);
+  return make_pair(q, r);
+}
+
+//Each pass strips up to 32 bits' worth of one prime of the base from
+//divexact's divisor; past this many, general division is cheaper.
+static const size_t EXACT_STRIP_PASSES = 8;
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+//  a / b for callers who know the remainder is zero; the result is
+//  meaningless otherwise.
+//     - Trailing zero digits of b, then the factors b's low digit
+//       shares with the base, are divided out of both first
+//     - Exact division then applies, as b's low digit is invertible
+//       modulo the base; general division is used instead when both b
+//       and the quotient are large enough for Newton division, or when
+//       b has too many factors of the base to divide out cheaply
+*/
+BigInt divexact(const BigInt &a, const BigInt &b){
+    if(a.base != b.base){
+        return divexact(a, mixedBase(b, a.base));
+    }
+    if(b.is_zero()){
+        throw DivByZeroException();
+    }
+  
+  int base = a.base;
+  bool sign = a.isPositive == b.isPositive;
+  BigInt x(a);
+  BigInt y(b);
+  x.isPositive = true;
+  y.isPositive = true;
+  trimStore(x.vec);
+  trimStore(y.vec);
+  
+  //strip trailing zero digits
+  size_t k = 0;
+  while(k + 1 < y.vec.size() && y.vec[k] == 0) {
+    k++;
+  }
+  if(k > 0) {
+    if(x.vec.size() <= k) {
+      return baseConstants(base).zero;
+    }
+    y.vec.erase(y.vec.begin(), y.vec.begin() + k);
+    x.vec.erase(x.vec.begin(), x.vec.begin() + k);
+  }
+  
+  //divide out each prime p of the base that b's low digit has: with
+  //P the largest power of p below 2^32 (m digits), b mod P comes from
+  //b's low m digits and gcd(b mod P, P) divides both exactly
+  int rest = base;
+  size_t passes = 0;
+  bool exact = true;
+  for(int p = 2; rest > 1 && exact; p++) {
+    if(rest % p != 0) {
+      continue;
+    }
+    while(rest % p == 0) {
+      rest /= p;
+    }
+    uint64_t power = p;
+    size_t m = 1;
+    while(power * p <= ((uint64_t)1 << 32)) {
+      power *= p;
+      m++;
+    }
+    while(y.vec[0] % p == 0) {
+      if(passes == EXACT_STRIP_PASSES) {
+        exact = false;
+        break;
+      }
+      passes++;
+      uint64_t low = 0;
+      for(size_t i = min(m, y.vec.size()); i-- > 0; ) {
+        low = (low * base + y.vec[i]) % power;
+      }
+      uint64_t d = power;
+      while(low != 0) {
+        uint64_t t = d % low;
+        d = low;
+        low = t;
+      }
+      divSmallDigits(x.vec.write(), base, d);
+      divSmallDigits(y.vec.write(), base, d);
+    }
+  }
+  
+  BigInt result(base);
+  if(x < y) {
+    result.vec.push_back(0);
+    return result;
+  }
+  
+  size_t threshold = newtonDigits(base);
+  bool newton = y.vec.size() >= threshold && x.vec.size() - y.vec.size() >= threshold;
+  if(exact && !newton) {
+    vector<int> q;
+    divExactDigits(x.vec, y.vec, base, q);
+    result.vec = move(q);
+  }
+  else {
+    result = x / y;
+  }
+  result.isPositive = sign || result.is_zero();
+  return result;
+}
+
+/*
+//  Main function for the Division (/=) and Modulus (%=) operators.
+//     - Compute (q)uotient and (r)emainder
+//     - Implement Long Division
+*/
+void BigInt::divisionMain(const BigInt &b, BigInt &quotient, BigInt &remainder){
+
+//1
+  BigInt divisor(b);               
+  BigInt dividend(*this); 
+  bool sign = isPositive == b.isPositive;
+  bool startsign = isPositive;
+  dividend.isPositive = true;
+  divisor.isPositive = true;
+
+  
+  //divide by one
+  if(divisor.is_one()) {
+    quotient = dividend;
+    quotient.isPositive = sign || quotient.is_zero();
+    remainder.vec.push_back(0);
+    remainder.isPositive = true;
+    return;
+  }
+  
+  //divide by itself
+  if(divisor == dividend) {
+    quotient.vec.push_back(1);
+    quotient.isPositive = sign;
+    remainder.vec.push_back(0);
+    remainder.isPositive = true;
+    return;
+  }
+  
+  //divide by a bigger number
+  if(dividend < divisor) {
+    quotient.vec.push_back(0);
+    quotient.isPositive = true;
+    remainder = *this;
+    return;
+  }
+  
+  //divide by a power of the base: split the digits
+  size_t k;
+  if(powerOfBase(divisor.vec, k)) {
+    trimStore(dividend.vec);
+    vector<int> q(dividend.vec.begin() + k, dividend.vec.end());
+    vector<int> r(dividend.vec.begin(), dividend.vec.begin() + k);
+    trimDigits(q);
+    trimDigits(r);
+    quotient.vec = move(q);
+    remainder.vec = move(r);
+    quotient.isPositive = sign || isZeroDigits(quotient.vec);
+    remainder.isPositive = startsign || isZeroDigits(remainder.vec);
+    return;
+  }
+  
+  //divide by a single machine word: one short division pass
+  uint64_t word;
+  if(digitsToU64(divisor.vec, base, word)) {
+    if(word == 0) {
+      throw DivByZeroException();
+    }
+    vector<int> q(dividend.vec.begin(), dividend.vec.end());
+    vector<int> r;
+    u64ToDigits(divSmallDigits(q, base, word), base, r);
+    quotient.vec = move(q);
+    remainder.vec = move(r);
+    quotient.isPositive = sign || isZeroDigits(quotient.vec);
+    remainder.isPositive = startsign || isZeroDigits(remainder.vec);
+    return;
+  }
+  
+  //divide by a power of two: shift bits
+  int s = log2Base(base);
+  if(s != 0 && powerOfTwo(divisor.vec, base, k)) {
+    trimStore(dividend.vec);
+    //the low k bits are whole digits plus part of one more digit
+    size_t whole = k / s;
+    quotient = dividend;
+    quotient >>= k;
+    vector<int> r(dividend.vec.begin(), dividend.vec.begin() + whole);
+    r.push_back(dividend.vec[whole] & ((1 << (k % s)) - 1));
+    trimDigits(r);
+    remainder.vec = move(r);
+    quotient.isPositive = sign || isZeroDigits(quotient.vec);
+    remainder.isPositive = startsign || isZeroDigits(remainder.vec);
+    return;
+  }
+  
+  //long division
+  trimStore(dividend.vec);
+  trimStore(divisor.vec);
+  size_t n = divisor.vec.size();
+  size_t threshold = newtonDigits(base);
+  if(n >= threshold && dividend.vec.size() - n >= threshold) {
+    dividend.divisionNewton(divisor, quotient, remainder);
+  }
+  else {
+    vector<int> q;
+    vector<int> r;
+    divDigits(dividend.vec, divisor.vec, base, q, r);
+    quotient.vec = move(q);
+    remainder.vec = move(r);
+  }
+  quotient.isPositive = sign || isZeroDigits(quotient.vec);
+  remainder.isPositive = startsign || isZeroDigits(remainder.vec);
+}
+
+/*
+//  floor(base^2n / *this) for a positive n-digit *this.
+//     - Recursively take the reciprocal of the top half of the digits,
+//       which is good to about n/2 digits
+//     - One Newton step x += x * (base^2n - b*x) / base^2n doubles that
+//     - The last few units are fixed by comparing b*x with base^2n
+*/
+BigInt BigInt::reciprocal() const{
+  size_t n = vec.size();
+  BigInt power(1, base);
+  shiftUpDigits(power.vec.write(), 2 * n);
+  
+  if(n < newtonDigits(base)) {
+    return power / *this;
+  }
+  
+  //half the digits plus guard digits, since a small top digit costs
+  //almost a digit of relative precision on each side of the step
+  size_t h = n / 2 + 3;
+  BigInt top(base);
+  top.vec.assign(vec.begin() + (n - h), vec.end());
+  BigInt x = top.reciprocal();
+  shiftUpDigits(x.vec.write(), n - h);
+  
+  //Newton step
+  BigInt step = x * (power - *this * x);
+  shiftDownDigits(step.vec.write(), 2 * n);
+  step.isPositive = step.isPositive || step.is_zero();
+  x += step;
+  
+  //correct to 0 <= base^2n - b*x < b
+  BigInt error = power - *this * x;
+  while(!error.isPositive) {
+    x -= baseConstants(base).one;
+    error += *this;
+  }
+  while(error >= *this) {
+    x += baseConstants(base).one;
+    error -= *this;
+  }
+  return x;
+}
+
+/*
+//  Division of positive values through a reciprocal of b (n digits).
+//    The dividend is consumed from the top in n-digit chunks, so every
+//    step divides a value below b*base^n by b (Barrett): the quotient
+//    chunk is estimated from the top digits times the reciprocal, which
+//    undershoots by at most a couple of units.
+*/
+void BigInt::divisionNewton(const BigInt &b, BigInt &quotient, BigInt &remainder) const{
+  size_t n = b.vec.size();
+  size_t na = vec.size();
+  size_t chunks = (na + n - 1) / n;
+  BigInt inverse = b.reciprocal();
+  const BigInt &one = baseConstants(base).one;
+  
+  BigInt rem(0, base);
+  vector<int> q(na, 0);
+  
+  for(size_t c = chunks; c-- > 0; ) {
+    checkCancelled();
+    
+    //cur = rem * base^n + the next chunk
+    BigInt cur(rem);
+    shiftUpDigits(cur.vec.write(), n);
+    BigInt chunk(base);
+    chunk.vec.assign(vec.begin() + c * n, vec.begin() + min(na, (c + 1) * n));
+    trimDigits(chunk.vec.write());
+    chunk.isPositive = true;
+    cur += chunk;
+    
+    //estimate, then fix up
+    BigInt estimate(cur);
+    shiftDownDigits(estimate.vec.write(), n - 1);
+    estimate *= inverse;
+    shiftDownDigits(estimate.vec.write(), n + 1);
+    rem = cur - estimate * b;
+    while(rem >= b) {
+      estimate += one;
+      rem -= b;
+    }
+    
+    for(size_t i = 0; i < estimate.vec.size() && !estimate.is_zero(); i++) {
+      q[c * n + i] = estimate.vec[i];
+    }
+  }
+  
+  trimDigits(q);
+  quotient.vec = move(q);
+  remainder = rem;
+  remainder.isPositive = true;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt pow(const  BigInt &a, const BigInt & b){
+  
+  BigInt c(a);
+  c.exponentiation(b);
+  return c;
+
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+*/
+const BigInt & BigInt::exponentiation(const BigInt &b){
+    if(base != b.base){
+        return exponentiation(mixedBase(b, base));
+    }
+    if(!b.isPositive){
+        throw ExpByNegativeException();
+    }
+
+  BigInt acopy(*this);
+  const BigInt &one = baseConstants(base).one;
+  
+  //read the exponent bits once instead of dividing it by two each step
+  vector<uint32_t> bits;
+  digitsToWords(b.vec, base, bits);
+  
+  //b = 0
+  if(bits.empty()) {
+    *this = one;
+    return *this;
+  }
+  
+  //square and multiply from the most significant bit down
+  int top = (bits.size() - 1) * 32 + wordBitLength(bits.back()) - 1;
+  ProgressScope scope;
+  
+  for(int i = top - 1; i >= 0; i--) {
+    checkCancelled();
+    reportProgress((double)(top - 1 - i) / top);
+    acopy.square();
+    if((bits[i / 32] >> (i % 32)) & 1) {
+      acopy *= *this;
+    }
+  }
+  *this = acopy;
+  return *this;
+    
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt modPow(const BigInt &a, const BigInt &b, const BigInt &m){  
+
+  BigInt c(a);
+  c.modulusExp(b, m);
+  return c;
+
+}
+ 
+
+/*
+//==================
+// MEMBER function
+//==================
+*/
+const BigInt & BigInt::modulusExp(const BigInt &b, const BigInt &m){
+    if(base != b.base || base != m.base){
+        return modulusExp(mixedBase(b, base), mixedBase(m, base));
+    }
+    if(!b.isPositive){
+        throw ExpByNegativeException();
+    }
+ 
+  BigInt acopy(*this);
+  acopy %= m;
+  
+  //read the exponent bits once instead of dividing it by two each step
+  vector<uint32_t> bits;
+  digitsToWords(b.vec, base, bits);
+  
+  //b = 0
+  if(bits.empty()) {
+    *this = baseConstants(base).one % m;
+    return *this;
+  }
+  
+  //square and multiply from the most significant bit down
+  BigInt start(acopy);
+  int top = (bits.size() - 1) * 32 + wordBitLength(bits.back()) - 1;
+  ProgressScope scope;
+  
+  for(int i = top - 1; i >= 0; i--) {
+    checkCancelled();
+    reportProgress((double)(top - 1 - i) / top);
+    acopy.square();
+    acopy %= m;
+    if((bits[i / 32] >> (i % 32)) & 1) {
+      acopy *= start;
+      acopy %= m;
+    }
+  }
+  *this = acopy;
+  
+    return *this;
+}
+
+//******************************************************************
+//END OF THE ARITHMETIC OPERATORS SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE NATIVE INTEGER OPERATORS SECTION
+//	Kernels behind the int64_t/uint64_t overloads in bigint.h.
+//	The operand arrives as a magnitude and a sign and is applied
+//	to the digits in place.
+//******************************************************************
+
+/*
+//  Compare with a native integer.
+//     If a = b, return 0.
+//     If a < b, return -1.
+//     If a > b, return 1.
+*/
+int BigInt::compareSmall(uint64_t mag, bool negative) const{
+  bool zero = isZeroDigits(vec);
+  bool neg = !isPositive && !zero;
+  
+  if(mag == 0) {
+    negative = false;
+  }
+  
+  //First compare the signs
+  if(neg != negative) {
+    if(neg) {
+      return -1;
+    }
+    return 1;
+  }
+  
+  //Same sign, compare magnitudes
+  int cmp = compareSmallDigits(vec, base, mag);
+  if(neg) {
+    return -cmp;
+  }
+  return cmp;
+}
+
+/*
+//  Add a native integer (magnitude and sign) in place.
+*/
+const BigInt & BigInt::addSmall(uint64_t mag, bool negative){
+  trimDigits(vec.write());
+  
+  //zero
+  if(mag == 0) {
+    return *this;
+  }
+  if(isZeroDigits(vec)) {
+    u64ToDigits(mag, base, vec.write());
+    isPositive = !negative;
+    return *this;
+  }
+  
+  //same signs, add magnitudes
+  if(isPositive != negative) {
+    addSmallDigits(vec.write(), base, mag);
+    return *this;
+  }
+  
+  //different signs, subtract the smaller magnitude from the larger
+  if(compareSmallDigits(vec, base, mag) >= 0) {
+    subSmallDigits(vec.write(), base, mag);
+  }
+  else {
+    uint64_t value;
+    digitsToU64(vec, base, value);
+    u64ToDigits(mag - value, base, vec.write());
+    isPositive = !isPositive;
+  }
+  
+  if(isZeroDigits(vec)) {
+    isPositive = true;
+  }
+  return *this;
+}
+
+/*
+//  Multiply by a native integer (magnitude and sign) in place.
+*/
+const BigInt & BigInt::mulSmall(uint64_t mag, bool negative){
+  trimDigits(vec.write());
+  
+  mulSmallDigits(vec.write(), base, mag, 0);
+  isPositive = isPositive != negative || isZeroDigits(vec);
+  return *this;
+}
+
+/*
+//  Divide by a native integer (magnitude and sign) in place.
+//     Truncates toward zero like operator /=.
+*/
+const BigInt & BigInt::divSmall(uint64_t mag, bool negative){
+    if(mag == 0){
+        throw DivByZeroException();
+    }
+  
+  trimDigits(vec.write());
+  divSmallDigits(vec.write(), base, mag);
+  isPositive = isPositive != negative || isZeroDigits(vec);
+  return *this;
+}
+
+/*
+//  Remainder by a native integer in place.
+//     The result takes the sign of the dividend like operator %=.
+*/
+const BigInt & BigInt::modSmall(uint64_t mag){
+    if(mag == 0){
+        throw DivByZeroException();
+    }
+  
+  trimDigits(vec.write());
+  uint64_t rem = divSmallDigits(vec.write(), base, mag);
+  u64ToDigits(rem, base, vec.write());
+  isPositive = isPositive || rem == 0;
+  return *this;
+}
+
+//******************************************************************
+//END OF THE NATIVE INTEGER OPERATORS SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE BITWISE OPERATORS SECTION
+//******************************************************************
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt operator << (const BigInt &a, size_t shift){
+  
+  BigInt c(a);
+  c <<= shift;
+  return c;
+
+}
+
+//In other bases, shifts up to this many bits run as short
+//multiplications/divisions by 2^32; longer ones build 2^shift.
+static const size_t SHIFT_LOOP_BITS = 64;
+
+/*
+// out = 2^shift in digits of the base, from the cached (2^32)^(2^k).
+*/
+static void powerOfTwoDigits(size_t shift, int base, vector<int> &out){
+  out.assign(1, 1);
+  mulSmallDigits(out, base, (uint64_t)1 << (shift % 32), 0);
+  
+  vector<int> product;
+  size_t words = shift / 32;
+  for(size_t k = 0; words != 0; k++, words >>= 1) {
+    if(words & 1) {
+      const vector<int> &power = wordPower(base, k);
+      mulDigits(out.data(), out.size(), power.data(), power.size(), base, product);
+      out.swap(product);
+    }
+  }
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+//  Multiply by 2^shift.
+//     - Power-of-two bases move whole digits and then at most one
+//       short multiplication.
+//     - Other bases multiply by up to 2^32 per pass for short shifts,
+//       and by 2^shift in one multiplication otherwise.
+*/
+const BigInt & BigInt::operator <<= (size_t shift){
+  trimDigits(vec.write());
+  
+  if(isZeroDigits(vec)) {
+    isPositive = true;
+    return *this;
+  }
+  
+  int s = log2Base(base);
+  if(s != 0) {
+    vec.insert(vec.begin(), shift / s, 0);
+    shift %= s;
+  }
+  else if(shift > SHIFT_LOOP_BITS) {
+    vector<int> power;
+    vector<int> product;
+    powerOfTwoDigits(shift, base, power);
+    mulDigits(vec.data(), vec.size(), power.data(), power.size(), base, product);
+    vec = move(product);
+    shift = 0;
+  }
+  
+  while(shift > 0) {
+    size_t step = min(shift, (size_t)32);
+    mulSmallDigits(vec.write(), base, (uint64_t)1 << step, 0);
+    shift -= step;
+  }
+  return *this;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt operator >> (const BigInt &a, size_t shift){
+  
+  BigInt c(a);
+  c >>= shift;
+  return c;
+
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+//  Divide by 2^shift, rounding toward negative infinity
+//  (so -1 >> n stays -1, like a two's complement shift).
+//  Long shifts in other bases are one division by 2^shift.
+*/
+const BigInt & BigInt::operator >>= (size_t shift){
+  trimDigits(vec.write());
+  bool inexact = false;
+  
+  int s = log2Base(base);
+  if(s != 0) {
+    size_t drop = shift / s;
+    if(drop >= vec.size()) {
+      inexact = !isZeroDigits(vec);
+      vec.assign(1, 0);
+    }
+    else {
+      for(size_t i = 0; i < drop; i++) {
+        if(vec[i] != 0) {
+          inexact = true;
+        }
+      }
+      vec.erase(vec.begin(), vec.begin() + drop);
+    }
+    shift %= s;
+  }
+  else if(shift > SHIFT_LOOP_BITS) {
+    BigInt magnitude(*this);
+    magnitude.isPositive = true;
+    BigInt power(base);
+    powerOfTwoDigits(shift, base, power.vec.write());
+    pair<BigInt, BigInt> qr = divmod(magnitude, power);
+    inexact = !qr.second.is_zero();
+    vec = qr.first.vec;
+    shift = 0;
+  }
+  
+  while(shift > 0) {
+    size_t step = min(shift, (size_t)32);
+    if(divSmallDigits(vec.write(), base, (uint64_t)1 << step) != 0) {
+      inexact = true;
+    }
+    shift -= step;
+  }
+  
+  //negative values round down, away from zero
+  if(!isPositive && inexact) {
+    mulSmallDigits(vec.write(), base, 1, 1);
+  }
+  
+  if(isZeroDigits(vec)) {
+    isPositive = true;
+  }
+  return *this;
+}
+
+/*
+//  Main function for the &=, |= and ^= operators.
+//     - Convert both magnitudes into binary words
+//     - Negative values become two's complement, one word wider than
+//       either operand so the sign extension is kept
+//     - Apply op (0 = and, 1 = or, 2 = xor) and convert back
+*/
+void BigInt::bitwiseMain(const BigInt &b, int op){
+  vector<uint32_t> wa;
+  vector<uint32_t> wb;
+  digitsToWords(vec, base, wa);
+  digitsToWords(b.vec, base, wb);
+  
+  bool nega = !isPositive && !wa.empty();
+  bool negb = !b.isPositive && !wb.empty();
+  
+  size_t len = max(wa.size(), wb.size()) + 1;
+  wa.resize(len, 0);
+  wb.resize(len, 0);
+  if(nega) {
+    negateWords(wa);
+  }
+  if(negb) {
+    negateWords(wb);
+  }
+  
+  bool negr;
+  if(op == 0) {
+    negr = nega && negb;
+    for(size_t i = 0; i < len; i++) {
+      wa[i] &= wb[i];
+    }
+  }
+  else if(op == 1) {
+    negr = nega || negb;
+    for(size_t i = 0; i < len; i++) {
+      wa[i] |= wb[i];
+    }
+  }
+  else {
+    negr = nega != negb;
+    for(size_t i = 0; i < len; i++) {
+      wa[i] ^= wb[i];
+    }
+  }
+  
+  if(negr) {
+    negateWords(wa);
+  }
+  while(!wa.empty() && wa.back() == 0) {
+    wa.pop_back();
+  }
+  
+  wordsToDigits(wa, base, vec.write());
+  isPositive = !negr;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt operator & (const BigInt &a, const BigInt &b){
+  
+  BigInt c(a);
+  c &= b;
+  return c;
+
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+*/
+const BigInt & BigInt::operator &= (const BigInt &b){
+    if(base != b.base){
+        return *this &= mixedBase(b, base);
+    }
+  
+  bitwiseMain(b, 0);
+  return *this;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt operator | (const BigInt &a, const BigInt &b){
+  
+  BigInt c(a);
+  c |= b;
+  return c;
+
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+*/
+const BigInt & BigInt::operator |= (const BigInt &b){
+    if(base != b.base){
+        return *this |= mixedBase(b, base);
+    }
+  
+  bitwiseMain(b, 1);
+  return *this;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt operator ^ (const BigInt &a, const BigInt &b){
+  
+  BigInt c(a);
+  c ^= b;
+  return c;
+
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+*/
+const BigInt & BigInt::operator ^= (const BigInt &b){
+    if(base != b.base){
+        return *this ^= mixedBase(b, base);
+    }
+  
+  bitwiseMain(b, 2);
+  return *this;
+}
+
+/*
+//  Bitwise not. In two's complement ~x == -x - 1.
+*/
+BigInt BigInt::operator ~ () const{
+  BigInt c(*this);
+  trimDigits(c.vec.write());
+  
+  if(c.isPositive || isZeroDigits(c.vec)) {
+    mulSmallDigits(c.vec.write(), base, 1, 1);
+    c.isPositive = false;
+  }
+  else {
+    decrementDigits(c.vec.write(), base);
+    c.isPositive = true;
+  }
+  return c;
+}
+
+/*
+//  Number of bits needed to write |x|. Zero has bit length 0.
+//    Power-of-two bases read it straight off the top digit.
+*/
+size_t BigInt::bit_length() const{
+  int s = log2Base(base);
+  
+  if(s != 0) {
+    int top = (int)vec.size() - 1;
+    while(top >= 0 && vec[top] == 0) {
+      top--;
+    }
+    if(top < 0) {
+      return 0;
+    }
+    return (size_t)top * s + wordBitLength(vec[top]);
+  }
+  
+  vector<uint32_t> words;
+  digitsToWords(vec, base, words);
+  if(words.empty()) {
+    return 0;
+  }
+  return (words.size() - 1) * 32 + wordBitLength(words.back());
+}
+
+/*
+//  Number of set bits in |x|.
+*/
+size_t BigInt::popcount() const{
+  size_t count = 0;
+  
+  if(log2Base(base) != 0) {
+    for(unsigned int i = 0; i < vec.size(); i++) {
+      count += wordPopcount(vec[i]);
+    }
+    return count;
+  }
+  
+  vector<uint32_t> words;
+  digitsToWords(vec, base, words);
+  for(unsigned int i = 0; i < words.size(); i++) {
+    count += wordPopcount(words[i]);
+  }
+  return count;
+}
+
+/*
+//  Bit n of x, treating negative values as infinite two's complement.
+//    For x < 0 the bits are the inverted bits of |x| - 1.
+*/
+bool BigInt::test_bit(size_t n) const{
+  int s = log2Base(base);
+  bool negative = !isPositive && !isZeroDigits(vec);
+  
+  if(s != 0 && !negative) {
+    size_t digit = n / s;
+    if(digit >= vec.size()) {
+      return false;
+    }
+    return (vec[digit] >> (n % s)) & 1;
+  }
+  
+  vector<int> mag(vec);
+  if(negative) {
+    decrementDigits(mag, base);
+  }
+  vector<uint32_t> words;
+  digitsToWords(mag, base, words);
+  
+  bool bit = false;
+  if(n / 32 < words.size()) {
+    bit = (words[n / 32] >> (n % 32)) & 1;
+  }
+  return bit != negative;
+}
+
+//******************************************************************
+//END OF THE BITWISE OPERATORS SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE ACCUMULATOR SECTION
+//******************************************************************
+
+//Limbs are resolved before their bound passes this, far below INT64_MAX.
+static const int64_t ACCUMULATOR_LIMIT = (int64_t)1 << 62;
+
+/*
+// Create an empty accumulator with base 10.
+*/
+BigIntAccumulator::BigIntAccumulator(){
+  base = 10;
+  load = 0;
+}
+
+/*
+// Create an empty accumulator with a specified base.
+*/
+BigIntAccumulator::BigIntAccumulator(int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  base = setbase;
+  load = 0;
+}
+
+/*
+//  Make room for a term that can move any limb by up to extra and that
+//  touches the first size limbs. Resolves carries first if the bound
+//  would pass ACCUMULATOR_LIMIT.
+*/
+void BigIntAccumulator::reserve(int64_t extra, size_t size){
+  if(load > ACCUMULATOR_LIMIT - extra) {
+    normalize();
+  }
+  load += extra;
+  
+  //one spare limb on top so normalize always has somewhere to carry
+  if(limbs.size() < size + 1) {
+    limbs.resize(size + 1, 0);
+  }
+}
+
+/*
+//  Add (or subtract) the digits of b, no carries.
+*/
+void BigIntAccumulator::addDigits(const BigInt &b, bool negative){
+    if(base != b.base){
+        addDigits(mixedBase(b, base), negative);
+        return;
+    }
+  
+  if(b.is_zero()) {
+    return;
+  }
+  reserve(base - 1, b.vec.size());
+  
+  if(negative) {
+    for(unsigned int i = 0; i < b.vec.size(); i++) {
+      limbs[i] -= b.vec[i];
+    }
+  }
+  else {
+    for(unsigned int i = 0; i < b.vec.size(); i++) {
+      limbs[i] += b.vec[i];
+    }
+  }
+}
+
+BigIntAccumulator & BigIntAccumulator::operator += (const BigInt &b){
+  addDigits(b, !b.isPositive);
+  return *this;
+}
+
+BigIntAccumulator & BigIntAccumulator::operator -= (const BigInt &b){
+  addDigits(b, b.isPositive);
+  return *this;
+}
+
+/*
+//  Multiply-accumulate: add a * b.
+//     - Schoolbook product straight into the limbs, no carries
+//     - Each limb gains at most min(size) * (base-1)^2
+*/
+void BigIntAccumulator::add_product(const BigInt &a, const BigInt &b){
+    if(base != a.base || base != b.base){
+        add_product(mixedBase(a, base), mixedBase(b, base));
+        return;
+    }
+  
+  if(a.is_zero() || b.is_zero()) {
+    return;
+  }
+  
+  int64_t sign = 1;
+  if(a.isPositive != b.isPositive) {
+    sign = -1;
+  }
+  
+  //long operands: the Karatsuba product plus one pass is cheaper
+  if(min(a.vec.size(), b.vec.size()) >= KARATSUBA_THRESHOLD) {
+    vector<int> product;
+    mulDigits(a.vec.data(), a.vec.size(), b.vec.data(), b.vec.size(), base, product);
+    reserve(base - 1, product.size());
+    for(unsigned int i = 0; i < product.size(); i++) {
+      limbs[i] += sign * product[i];
+    }
+    return;
+  }
+  
+  int64_t step = (int64_t)(base - 1) * (base - 1);
+  int64_t extra = (int64_t)min(a.vec.size(), b.vec.size()) * step;
+  reserve(extra, a.vec.size() + b.vec.size());
+  
+  for(unsigned int i = 0; i < a.vec.size(); i++) {
+    int64_t ai = sign * a.vec[i];
+    if(ai == 0) {
+      continue;
+    }
+    for(unsigned int k = 0; k < b.vec.size(); k++) {
+      limbs[i+k] += ai * b.vec[k];
+    }
+  }
+}
+
+/*
+//  Resolve carries.
+//     - Every limb but the top one ends up in [0, base)
+//     - The top limb is -1 when the sum is negative, so the value is
+//       limbs[0..n-1] - base^n
+*/
+void BigIntAccumulator::normalize(){
+  int64_t carry = 0;
+  
+  for(unsigned int i = 0; i < limbs.size(); i++) {
+    int64_t cur = limbs[i] + carry;
+    int64_t digit = cur % base;
+    if(digit < 0) {
+      digit += base;
+    }
+    limbs[i] = digit;
+    carry = (cur - digit) / base;
+  }
+  
+  while(carry != 0 && carry != -1) {
+    int64_t digit = carry % base;
+    if(digit < 0) {
+      digit += base;
+    }
+    limbs.push_back(digit);
+    carry = (carry - digit) / base;
+  }
+  limbs.push_back(carry);
+  
+  //drop zero limbs above the top, keeping the sign limb
+  while(limbs.size() > 1 && limbs[limbs.size()-1] == 0 && limbs[limbs.size()-2] == 0) {
+    limbs.pop_back();
+  }
+  if(limbs.size() > 1 && limbs.back() == 0) {
+    limbs.pop_back();
+  }
+  
+  load = base;
+}
+
+/*
+//  Read the sum.
+*/
+BigInt BigIntAccumulator::value(){
+  BigInt result(base);
+  
+  if(limbs.empty()) {
+    result.vec.push_back(0);
+    return result;
+  }
+  normalize();
+  
+  size_t n = limbs.size() - 1;
+  if(limbs[n] >= 0) {
+    for(size_t i = 0; i <= n; i++) {
+      result.vec.push_back(limbs[i]);
+    }
+  }
+  else {
+    //base^n - low: complement every digit, then add one
+    for(size_t i = 0; i < n; i++) {
+      result.vec.push_back(base - 1 - limbs[i]);
+    }
+    addSmallDigits(result.vec.write(), base, 1);
+    result.isPositive = false;
+  }
+  
+  trimDigits(result.vec.write());
+  if(result.is_zero()) {
+    result.isPositive = true;
+  }
+  return result;
+}
+
+/*
+//  Reset the sum to zero.
+*/
+void BigIntAccumulator::clear(){
+  limbs.clear();
+  load = 0;
+}
+
+//******************************************************************
+//END OF THE ACCUMULATOR SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE FIXED BASE EXPONENTIATION SECTION
+//******************************************************************
+
+/*
+//  Build the table for g and m, covering exponents up to maxBits bits.
+//     - Reduce g into [0, m) so every table entry is non-negative
+//     - For each window position i, with step = g^(2^(window*i)),
+//       store step^1 .. step^(2^window - 1)
+//     - The next step is step^(2^window) = last entry * step
+*/
+FixedBaseExp::FixedBaseExp(const BigInt &g, const BigInt &m, size_t maxBits, int setwindow){
+    if(m.is_zero()){
+        throw DivByZeroException();
+    }
+    if(setwindow < 1 || setwindow > 16){
+        throw InvalidWindowException();
+    }
+  
+  mod = m;
+  mod.isPositive = true;
+  window = setwindow;
+  windows = (maxBits + window - 1) / window;
+  
+  BigInt step(g);
+  if(step.base != mod.base) {
+    step = mixedBase(g, mod.base);
+  }
+  step %= mod;
+  if(!step.isPositive) {
+    step += mod;
+  }
+  
+  size_t perWindow = ((size_t)1 << window) - 1;
+  table.reserve(windows * perWindow);
+  
+  for(size_t i = 0; i < windows; i++) {
+    table.push_back(step);
+    for(size_t d = 2; d <= perWindow; d++) {
+      BigInt next(table.back());
+      next *= step;
+      next %= mod;
+      table.push_back(next);
+    }
+    step *= table.back();
+    step %= mod;
+  }
+  top = step;
+}
+
+/*
+//  g^e mod m.
+//     - Multiply together the table entry for every nonzero window of e
+//     - Bits of e past maxBits fall back to modPow on top
+*/
+BigInt FixedBaseExp::pow(const BigInt &e) const{
+    if(e.base != mod.base){
+        return pow(mixedBase(e, mod.base));
+    }
+    if(!e.isPositive){
+        throw ExpByNegativeException();
+    }
+  
+  vector<uint32_t> bits;
+  digitsToWords(e.vec, e.base, bits);
+  
+  size_t perWindow = ((size_t)1 << window) - 1;
+  BigInt result(1, mod.base);
+  bool empty = true;
+  
+  for(size_t i = 0; i < windows; i++) {
+    //read window i of the exponent
+    size_t d = 0;
+    for(int k = window - 1; k >= 0; k--) {
+      size_t bit = i * window + k;
+      d <<= 1;
+      if(bit / 32 < bits.size()) {
+        d |= (bits[bit / 32] >> (bit % 32)) & 1;
+      }
+    }
+    if(d == 0) {
+      continue;
+    }
+    
+    if(empty) {
+      result = table[i * perWindow + d - 1];
+      empty = false;
+    }
+    else {
+      result *= table[i * perWindow + d - 1];
+      result %= mod;
+    }
+  }
+  
+  //exponent longer than the table
+  size_t length = 0;
+  if(!bits.empty()) {
+    length = (bits.size() - 1) * 32 + wordBitLength(bits.back());
+  }
+  if(length > windows * window) {
+    result *= modPow(top, e >> (windows * window), mod);
+    result %= mod;
+  }
+  
+  if(empty) {
+    result %= mod;
+  }
+  return result;
+}
+
+/*
+//  Number of residues held in the table.
+*/
+size_t FixedBaseExp::table_size() const{
+  return table.size();
+}
+
+//******************************************************************
+//END OF THE FIXED BASE EXPONENTIATION SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE MULTI-EXPONENTIATION SECTION
+//	multi_modPow computes g1^e1 * g2^e2 * ... * gk^ek mod m with a
+//	single shared squaring chain.
+//	  - Straus (interleaved windows) for a few terms: a small table
+//	    of powers per base, one multiplication per nonzero window.
+//	  - Pippenger (buckets) for many terms: bases are dropped into
+//	    buckets by window value, and the buckets are combined with
+//	    a running product, so the table cost no longer grows with k.
+//******************************************************************
+
+//From this many terms on, buckets beat per-base tables.
+static const size_t PIPPENGER_THRESHOLD = 32;
+
+/*
+// Read w bits of an exponent starting at bit pos.
+*/
+static size_t exponentWindow(const vector<uint32_t> &bits, size_t pos, int w){
+  size_t d = 0;
+  
+  for(int k = w - 1; k >= 0; k--) {
+    size_t bit = pos + k;
+    d <<= 1;
+    if(bit / 32 < bits.size()) {
+      d |= (bits[bit / 32] >> (bit % 32)) & 1;
+    }
+  }
+  return d;
+}
+
+/*
+// acc = acc * b mod m, where an empty acc stands for 1.
+*/
+static void mulModInto(BigInt &acc, bool &empty, const BigInt &b, const BigInt &m){
+  if(empty) {
+    acc = b;
+    empty = false;
+    return;
+  }
+  acc *= b;
+  acc %= m;
+}
+
+BigInt multi_modPow(const vector<BigInt> &bases, const vector<BigInt> &exponents, const BigInt &m){
+    if(bases.size() != exponents.size()){
+        throw SizeMismatchException();
+    }
+    if(m.is_zero()){
+        throw DivByZeroException();
+    }
+  
+  BigInt mod(m);
+  mod.isPositive = true;
+  size_t k = bases.size();
+  
+  //reduce the bases into [0, m) and read the exponent bits once
+  vector<BigInt> g(k, mod);
+  vector< vector<uint32_t> > bits(k);
+  size_t maxBits = 0;
+  
+  for(size_t j = 0; j < k; j++) {
+      if(!exponents[j].isPositive){
+          throw ExpByNegativeException();
+      }
+    g[j] = bases[j];
+    if(g[j].base != mod.base) {
+      g[j] = mixedBase(bases[j], mod.base);
+    }
+    g[j] %= mod;
+    if(!g[j].isPositive) {
+      g[j] += mod;
+    }
+    //exponents are only read as bits, so any base will do once allowed
+    if(exponents[j].base != mod.base && !BigInt::auto_convert()) {
+      throw DiffBaseException();
+    }
+    digitsToWords(exponents[j].vec, exponents[j].base, bits[j]);
+    if(!bits[j].empty()) {
+      maxBits = max(maxBits, (bits[j].size() - 1) * 32 + wordBitLength(bits[j].back()));
+    }
+  }
+  
+  BigInt acc(1, mod.base);
+  bool empty = true;
+  
+  if(k < PIPPENGER_THRESHOLD) {
+    //Straus: table[j][d-1] = g[j]^d
+    int w = 1;
+    if(maxBits > 24) {
+      w = 2;
+    }
+    if(maxBits > 80) {
+      w = 3;
+    }
+    if(maxBits > 240) {
+      w = 4;
+    }
+    if(maxBits > 672) {
+      w = 5;
+    }
+    size_t entries = ((size_t)1 << w) - 1;
+    
+    vector< vector<BigInt> > table(k);
+    for(size_t j = 0; j < k; j++) {
+      table[j].push_back(g[j]);
+      for(size_t d = 2; d <= entries; d++) {
+        BigInt next(table[j].back());
+        next *= g[j];
+        next %= mod;
+        table[j].push_back(next);
+      }
+    }
+    
+    size_t windows = (maxBits + w - 1) / w;
+    for(size_t i = windows; i-- > 0; ) {
+      if(!empty) {
+        for(int s = 0; s < w; s++) {
+          acc.square();
+          acc %= mod;
+        }
+      }
+      for(size_t j = 0; j < k; j++) {
+        size_t d = exponentWindow(bits[j], i * w, w);
+        if(d != 0) {
+          mulModInto(acc, empty, table[j][d-1], mod);
+        }
+      }
+    }
+  }
+  else {
+    //Pippenger: window about log2(k) bits
+    int w = max(2, wordBitLength(k) - 2);
+    w = min(w, 16);
+    size_t entries = ((size_t)1 << w) - 1;
+    
+    size_t windows = (maxBits + w - 1) / w;
+    for(size_t i = windows; i-- > 0; ) {
+      if(!empty) {
+        for(int s = 0; s < w; s++) {
+          acc.square();
+          acc %= mod;
+        }
+      }
+      
+      //bucket[d-1] = product of the bases whose window is d
+      vector<BigInt> bucket(entries, mod);
+      vector<bool> used(entries, false);
+      for(size_t j = 0; j < k; j++) {
+        size_t d = exponentWindow(bits[j], i * w, w);
+        if(d != 0) {
+          bool fresh = !used[d-1];
+          mulModInto(bucket[d-1], fresh, g[j], mod);
+          used[d-1] = true;
+        }
+      }
+      
+      //prod bucket[d-1]^d = running product of running products
+      BigInt running(mod);
+      bool runningEmpty = true;
+      for(size_t d = entries; d >= 1; d--) {
+        if(used[d-1]) {
+          mulModInto(running, runningEmpty, bucket[d-1], mod);
+        }
+        if(!runningEmpty) {
+          mulModInto(acc, empty, running, mod);
+        }
+      }
+    }
+  }
+  
+  if(empty) {
+    acc %= mod;
+  }
+  return acc;
+}
+
+//******************************************************************
+//END OF THE MULTI-EXPONENTIATION SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE PRIMALITY SECTION
+//	is_probable_prime: trial division by word-sized products of small
+//	primes, Miller-Rabin, then an optional strong Lucas test (the
+//	Baillie-PSW combination when lucas is on).
+//	next_prime: sieves a window of candidates against the small primes
+//	at once and only runs the full test on the survivors, optionally on
+//	several threads.
+//******************************************************************
+
+//Small primes used for trial division and sieving.
+static const unsigned int SMALL_PRIME_LIMIT = 2000;
+//Odd candidates sieved per window in next_prime.
+static const unsigned int SIEVE_WINDOW = 4096;
+
+/*
+//  Odd primes below SMALL_PRIME_LIMIT, grouped so the product of each
+//  group fits in 32 bits. n mod (group product) is one short division,
+//  and each prime in the group is then checked on that word.
+*/
+struct SmallPrimeGroups {
+  vector<uint32_t> primes;
+  vector<uint32_t> products;
+  vector<unsigned int> ends;
+  
+  SmallPrimeGroups(){
+    vector<bool> composite(SMALL_PRIME_LIMIT, false);
+    for(unsigned int i = 3; i < SMALL_PRIME_LIMIT; i += 2) {
+      if(composite[i]) {
+        continue;
+      }
+      primes.push_back(i);
+      for(unsigned int k = i * i; k < SMALL_PRIME_LIMIT; k += 2 * i) {
+        composite[k] = true;
+      }
+    }
+    
+    uint64_t product = 1;
+    for(unsigned int i = 0; i < primes.size(); i++) {
+      if(product * primes[i] > UINT32_MAX) {
+        products.push_back(product);
+        ends.push_back(i);
+        product = 1;
+      }
+      product *= primes[i];
+    }
+    products.push_back(product);
+    ends.push_back(primes.size());
+  }
+};
+
+static const SmallPrimeGroups & smallPrimes(){
+  static const SmallPrimeGroups groups;
+  return groups;
+}
+
+/*
+//  n mod m for n >= 0 and a native m.
+*/
+static uint64_t smallRemainder(const BigInt &n, uint64_t m){
+  return (n % m).to_uint64();
+}
+
+/*
+//  Jacobi symbol (a/m) for native a >= 0 and odd m.
+*/
+static int jacobiWord(uint64_t a, uint64_t m){
+  int result = 1;
+  a %= m;
+  
+  while(a != 0) {
+    while(a % 2 == 0) {
+      a /= 2;
+      if(m % 8 == 3 || m % 8 == 5) {
+        result = -result;
+      }
+    }
+    swap(a, m);
+    if(a % 4 == 3 && m % 4 == 3) {
+      result = -result;
+    }
+    a %= m;
+  }
+  
+  if(m == 1) {
+    return result;
+  }
+  return 0;
+}
+
+/*
+//  Jacobi symbol (d/n) for a small d and a big odd n > 0.
+//    Pull out the sign and the factors of two, then use reciprocity so
+//    only n mod |d| is needed.
+*/
+static int jacobiSmall(int64_t d, const BigInt &n){
+  int result = 1;
+  uint64_t n8 = smallRemainder(n, 8);
+  uint64_t a = d;
+  
+  if(d < 0) {
+    a = 0 - (uint64_t)d;
+    if(n8 % 4 == 3) {
+      result = -result;
+    }
+  }
+  if(a == 0) {
+    return 0;
+  }
+  
+  while(a % 2 == 0) {
+    a /= 2;
+    if(n8 == 3 || n8 == 5) {
+      result = -result;
+    }
+  }
+  
+  if(a % 4 == 3 && n8 % 4 == 3) {
+    result = -result;
+  }
+  return result * jacobiWord(smallRemainder(n, a), a);
+}
+
+/*
+//  Is n a perfect square? Newton iteration for floor(sqrt(n)).
+*/
+static bool isSquare(const BigInt &n){
+  BigInt x(1, n.get_base());
+  x <<= (n.bit_length() + 1) / 2;
+  
+  while(true) {
+    BigInt y(n);
+    y /= x;
+    y += x;
+    y >>= 1;
+    if(y >= x) {
+      break;
+    }
+    x = y;
+  }
+  return x * x == n;
+}
+
+/*
+//  x mod n in [0, n).
+*/
+static void reduceMod(BigInt &x, const BigInt &n){
+  x %= n;
+  if(x.sign() < 0) {
+    x += n;
+  }
+}
+
+/*
+//  x / 2 mod n for odd n and x in [0, n).
+*/
+static void halveMod(BigInt &x, const BigInt &n){
+  if(x.test_bit(0)) {
+    x += n;
+  }
+  x >>= 1;
+}
+
+/*
+//  One Miller-Rabin round: is n a strong probable prime to base a?
+//     n - 1 = d * 2^s with d odd.
+*/
+static bool millerRabin(const BigInt &n, const BigInt &nminus1, const BigInt &d, size_t s, const BigInt &a){
+  BigInt x = modPow(a, d, n);
+  
+  if(x.is_one() || x == nminus1) {
+    return true;
+  }
+  for(size_t r = 1; r < s; r++) {
+    x.square();
+    x %= n;
+    if(x == nminus1) {
+      return true;
+    }
+    if(x.is_one()) {
+      return false;
+    }
+  }
+  return false;
+}
+
+/*
+//  Strong Lucas probable prime test with Selfridge parameters:
+//  the first D in 5, -7, 9, -11, ... with (D/n) = -1, P = 1,
+//  Q = (1 - D) / 4.
+//     n + 1 = d * 2^s with d odd. n passes if U_d = 0, or V_(d*2^r) = 0
+//     for some 0 <= r < s.
+*/
+static bool strongLucas(const BigInt &n, const vector<uint32_t> &dbits, size_t s){
+  int64_t d = 5;
+  
+  while(true) {
+    int j = jacobiSmall(d, n);
+    if(j == -1) {
+      break;
+    }
+    if(j == 0 && n != (d < 0 ? -d : d)) {
+      return false;
+    }
+    //perfect squares never give -1, stop searching once it looks suspicious
+    if(d == 21 && isSquare(n)) {
+      return false;
+    }
+    if(d > 0) {
+      d = -(d + 2);
+    }
+    else {
+      d = -d + 2;
+    }
+  }
+  
+  BigInt Q((1 - d) / 4, n.get_base());
+  reduceMod(Q, n);
+  BigInt D(d, n.get_base());
+  reduceMod(D, n);
+  
+  //Lucas chain over the bits of d, starting from U_1 = 1, V_1 = P = 1
+  BigInt U(1, n.get_base());
+  BigInt V(U);
+  BigInt Qk(Q);
+  
+  size_t top = (dbits.size() - 1) * 32 + wordBitLength(dbits.back()) - 1;
+  for(size_t i = top; i-- > 0; ) {
+    //double: U_2k = U_k V_k, V_2k = V_k^2 - 2 Q^k
+    U *= V;
+    reduceMod(U, n);
+    V.square();
+    V -= Qk;
+    V -= Qk;
+    reduceMod(V, n);
+    Qk.square();
+    reduceMod(Qk, n);
+    
+    //add one: U_k+1 = (U + V) / 2, V_k+1 = (D U + V) / 2
+    if((dbits[i / 32] >> (i % 32)) & 1) {
+      BigInt nextU(U);
+      nextU += V;
+      reduceMod(nextU, n);
+      halveMod(nextU, n);
+      
+      BigInt nextV(D);
+      nextV *= U;
+      nextV += V;
+      reduceMod(nextV, n);
+      halveMod(nextV, n);
+      
+      U = nextU;
+      V = nextV;
+      Qk *= Q;
+      reduceMod(Qk, n);
+    }
+  }
+  
+  if(U.is_zero() || V.is_zero()) {
+    return true;
+  }
+  for(size_t r = 1; r < s; r++) {
+    V.square();
+    V -= Qk;
+    V -= Qk;
+    reduceMod(V, n);
+    if(V.is_zero()) {
+      return true;
+    }
+    Qk.square();
+    reduceMod(Qk, n);
+  }
+  return false;
+}
+
+/*
+//  Probable prime test.
+//     - Trial division by the small primes, one short division per
+//       group of primes
+//     - Miller-Rabin to base 2, then rounds-1 more random bases
+//     - Strong Lucas if lucas is set (base 2 + Lucas is BPSW)
+*/
+bool is_probable_prime(const BigInt &n, int rounds, bool lucas){
+  if(n.sign() <= 0 || n.is_one()) {
+    return false;
+  }
+  if(n == 2) {
+    return true;
+  }
+  if(!n.test_bit(0)) {
+    return false;
+  }
+  
+  //trial division
+  const SmallPrimeGroups &groups = smallPrimes();
+  unsigned int start = 0;
+  for(unsigned int g = 0; g < groups.products.size(); g++) {
+    uint64_t r = smallRemainder(n, groups.products[g]);
+    for(unsigned int i = start; i < groups.ends[g]; i++) {
+      if(r % groups.primes[i] == 0) {
+        return n == groups.primes[i];
+      }
+    }
+    start = groups.ends[g];
+  }
+  
+  //every factor up to the sieve limit has been ruled out
+  if(n < (uint64_t)SMALL_PRIME_LIMIT * SMALL_PRIME_LIMIT) {
+    return true;
+  }
+  
+  //n - 1 = d * 2^s
+  BigInt nminus1(n);
+  nminus1 -= 1;
+  BigInt d(nminus1);
+  size_t s = 0;
+  while(!d.test_bit(s)) {
+    s++;
+  }
+  d >>= s;
+  
+  const BigInt &two = baseConstants(n.get_base()).two;
+  if(!millerRabin(n, nminus1, d, s, two)) {
+    return false;
+  }
+  
+  //random bases in [2, n-2], reproducible for a given n
+  mt19937_64 rng(0x9E3779B97F4A7C15ULL ^ smallRemainder(n, UINT32_MAX));
+  BigInt range(nminus1);
+  range -= 2;
+  for(int round = 1; round < rounds; round++) {
+    BigInt a = random_below(range, rng);
+    a += 2;
+    if(!millerRabin(n, nminus1, d, s, a)) {
+      return false;
+    }
+  }
+  
+  if(!lucas) {
+    return true;
+  }
+  
+  //n + 1 = d * 2^s
+  BigInt nplus1(n);
+  nplus1 += 1;
+  size_t ls = 0;
+  while(!nplus1.test_bit(ls)) {
+    ls++;
+  }
+  nplus1 >>= ls;
+  vector<uint32_t> dbits;
+  digitsToWords(nplus1.vec, nplus1.base, dbits);
+  return strongLucas(n, dbits, ls);
+}
+
+/*
+//  Smallest probable prime greater than n.
+//     - Keep start mod p for every small prime p
+//     - For each window of SIEVE_WINDOW odd candidates, cross out the
+//       multiples of each p, then run is_probable_prime on what is left
+//     - With threads > 1 the survivors are tested in parallel, a batch
+//       at a time, and the smallest prime in the batch wins. The
+//       workers are started once; each batch bumps round, and they and
+//       this thread claim its candidates until all are tested.
+*/
+BigInt next_prime(const BigInt &n, int rounds, unsigned threads){
+  BigInt start(n);
+  start += 1;
+  
+  if(start <= 2) {
+    return baseConstants(n.get_base()).two;
+  }
+  if(!start.test_bit(0)) {
+    start += 1;
+  }
+  
+  const vector<uint32_t> &primes = smallPrimes().primes;
+  vector<uint32_t> residue(primes.size());
+  for(unsigned int i = 0; i < primes.size(); i++) {
+    residue[i] = smallRemainder(start, primes[i]);
+  }
+  
+  if(threads == 0) {
+    threads = 1;
+  }
+  
+  //a small start can land on the sieving primes themselves
+  uint64_t small = 0;
+  if(start < (uint64_t)SMALL_PRIME_LIMIT) {
+    small = start.to_uint64();
+  }
+  
+  mutex lock;
+  condition_variable wake;
+  condition_variable finished;
+  vector<BigInt> batch;
+  vector<char> prime;
+  size_t round = 0;
+  size_t taken = 0;
+  size_t done = 0;
+  bool stop = false;
+  exception_ptr error;
+  
+  //test the candidates of round r until none are left to claim
+  auto drain = [&](size_t r) {
+    while(true) {
+      size_t i;
+      {
+        lock_guard<mutex> guard(lock);
+        if(round != r || taken == batch.size()) {
+          return;
+        }
+        i = taken++;
+      }
+      char p = 0;
+      exception_ptr failed;
+      try {
+        p = is_probable_prime(batch[i], rounds);
+      }
+      catch(...) {
+        failed = current_exception();
+      }
+      lock_guard<mutex> guard(lock);
+      prime[i] = p;
+      if(failed && !error) {
+        error = failed;
+      }
+      if(++done == batch.size()) {
+        finished.notify_one();
+      }
+    }
+  };
+  
+  //the workers are stopped and joined however this returns or throws
+  vector<thread> workers;
+  struct Joiner {
+    function<void()> stopAll;
+    ~Joiner() { stopAll(); }
+  } joiner = {[&]() {
+    {
+      lock_guard<mutex> guard(lock);
+      stop = true;
+    }
+    wake.notify_all();
+    for(size_t t = 0; t < workers.size(); t++) {
+      workers[t].join();
+    }
+  }};
+  try {
+    for(unsigned int t = 1; t < threads; t++) {
+      workers.push_back(thread([&]() {
+        size_t seen = 0;
+        while(true) {
+          {
+            unique_lock<mutex> guard(lock);
+            wake.wait(guard, [&]() { return stop || round != seen; });
+            if(stop) {
+              return;
+            }
+            seen = round;
+          }
+          drain(seen);
+        }
+      }));
+    }
+  }
+  catch(...) {
+    //could not start every thread: carry on with the ones that did
+  }
+  
+  while(true) {
+    //composite[i] covers start + 2i
+    vector<bool> composite(SIEVE_WINDOW, false);
+    for(unsigned int i = 0; i < primes.size(); i++) {
+      uint32_t p = primes[i];
+      //first i with start + 2i = 0 mod p: 2i = -residue mod p
+      uint32_t first = (p - residue[i]) % p;
+      if(first % 2 == 1) {
+        first += p;
+      }
+      first /= 2;
+      if(small + 2 * first == p) {
+        first += p;
+      }
+      for(uint32_t k = first; k < SIEVE_WINDOW; k += p) {
+        composite[k] = true;
+      }
+    }
+    
+    vector<unsigned int> survivors;
+    for(unsigned int i = 0; i < SIEVE_WINDOW; i++) {
+      if(!composite[i]) {
+        survivors.push_back(i);
+      }
+    }
+    
+    for(unsigned int b = 0; b < survivors.size(); b += threads) {
+      unsigned int count = min((unsigned int)survivors.size() - b, threads);
+      size_t r;
+      {
+        lock_guard<mutex> guard(lock);
+        batch.clear();
+        for(unsigned int t = 0; t < count; t++) {
+          batch.push_back(start + 2 * survivors[b + t]);
+        }
+        prime.assign(count, 0);
+        taken = 0;
+        done = 0;
+        r = ++round;
+      }
+      if(count > 1) {
+        wake.notify_all();
+      }
+      drain(r);
+      {
+        unique_lock<mutex> guard(lock);
+        finished.wait(guard, [&]() { return done == batch.size(); });
+        if(error) {
+          rethrow_exception(error);
+        }
+      }
+      
+      for(unsigned int t = 0; t < count; t++) {
+        if(prime[t]) {
+          return batch[t];
+        }
+      }
+    }
+    
+    //next window
+    start += 2 * SIEVE_WINDOW;
+    small = 0;
+    for(unsigned int i = 0; i < primes.size(); i++) {
+      residue[i] = (residue[i] + 2 * SIEVE_WINDOW) % primes[i];
+    }
+  }
+}
+
+//******************************************************************
+//END OF THE PRIMALITY SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE RESIDUE NUMBER SYSTEM SECTION
+//******************************************************************
+
+/*
+//  Primes and CRT constants for one capacity.
+//     - primes: the largest primes below 2^31, so sums fit in 32 bits
+//       and products in 64 bits
+//     - inverse[i][j] = primes[j]^-1 mod primes[i], for j < i
+*/
+struct RnsBasis {
+  vector<uint32_t> primes;
+  vector< vector<uint32_t> > inverse;
+};
+
+/*
+//  a^e mod m for word-size values.
+*/
+static uint32_t powModWord(uint64_t a, uint64_t e, uint32_t m){
+  uint64_t result = 1;
+  a %= m;
+  
+  while(e != 0) {
+    if(e & 1) {
+      result = result * a % m;
+    }
+    a = a * a % m;
+    e >>= 1;
+  }
+  return result;
+}
+
+/*
+//  Deterministic primality test for 32-bit values (Miller-Rabin to
+//  bases 2, 7 and 61 is exact below 2^32).
+*/
+static bool isPrimeWord(uint32_t n){
+  if(n < 2 || n % 2 == 0) {
+    return n == 2;
+  }
+  uint32_t d = n - 1;
+  int s = 0;
+  while(d % 2 == 0) {
+    d /= 2;
+    s++;
+  }
+  
+  uint32_t witnesses[3] = {2, 7, 61};
+  for(int w = 0; w < 3; w++) {
+    if(witnesses[w] % n == 0) {
+      continue;
+    }
+    uint64_t x = powModWord(witnesses[w], d, n);
+    if(x == 1 || x == n - 1) {
+      continue;
+    }
+    bool composite = true;
+    for(int r = 1; r < s && composite; r++) {
+      x = x * x % n;
+      if(x == n - 1) {
+        composite = false;
+      }
+    }
+    if(composite) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+//  Shared basis with count primes. Built once per count and cached.
+*/
+static shared_ptr<const RnsBasis> rnsBasis(size_t count){
+  static mutex lock;
+  static map< size_t, shared_ptr<const RnsBasis> > cache;
+  
+  lock_guard<mutex> guard(lock);
+  shared_ptr<const RnsBasis> &slot = cache[count];
+  if(slot) {
+    return slot;
+  }
+  
+  shared_ptr<RnsBasis> basis = make_shared<RnsBasis>();
+  uint32_t candidate = 0x7FFFFFFF;
+  while(basis->primes.size() < count) {
+    if(isPrimeWord(candidate)) {
+      basis->primes.push_back(candidate);
+    }
+    candidate -= 2;
+  }
+  
+  basis->inverse.resize(count);
+  for(size_t i = 0; i < count; i++) {
+    uint32_t p = basis->primes[i];
+    for(size_t j = 0; j < i; j++) {
+      basis->inverse[i].push_back(powModWord(basis->primes[j], p - 2, p));
+    }
+  }
+  
+  slot = basis;
+  return slot;
+}
+
+/*
+//  Enough primes (each above 2^30) that their product exceeds
+//  2^(capacity+1), so the signed range covers +-2^capacity.
+*/
+static size_t rnsPrimeCount(size_t capacityBits){
+  return (capacityBits + 2 + 29) / 30;
+}
+
+/*
+// Create an RNS zero with room for capacityBits bits.
+*/
+RnsBigInt::RnsBigInt(size_t capacityBits, int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  base = setbase;
+  basis = rnsBasis(rnsPrimeCount(capacityBits));
+  residues.assign(basis->primes.size(), 0);
+}
+
+/*
+//  Create the residues of a BigInt.
+//     - Group the digits into chunks below 2^32
+//     - For every prime, run Horner over the chunks
+//     - Negative values use p - r
+*/
+RnsBigInt::RnsBigInt(const BigInt &b, size_t capacityBits){
+  base = b.base;
+  basis = rnsBasis(rnsPrimeCount(capacityBits));
+  
+  //chunk = base^per digits
+  int per = 0;
+  uint64_t chunkBase = 1;
+  while(chunkBase * base < ((uint64_t)1 << 32)) {
+    chunkBase *= base;
+    per++;
+  }
+  
+  vector<uint32_t> chunks;
+  for(int i = (int)b.vec.size() - 1; i >= 0; ) {
+    //the top chunk takes the leftover digits
+    int take = (i + 1) % per;
+    if(take == 0) {
+      take = per;
+    }
+    uint64_t value = 0;
+    for(int k = 0; k < take; k++, i--) {
+      value = value * base + b.vec[i];
+    }
+    chunks.push_back(value);
+  }
+  
+  bool negative = !b.isPositive && !b.is_zero();
+  residues.resize(basis->primes.size());
+  for(size_t j = 0; j < residues.size(); j++) {
+    uint64_t p = basis->primes[j];
+    uint64_t step = chunkBase % p;
+    uint64_t r = 0;
+    for(size_t i = 0; i < chunks.size(); i++) {
+      r = (r * step + chunks[i]) % p;
+    }
+    if(negative && r != 0) {
+      r = p - r;
+    }
+    residues[j] = r;
+  }
+}
+
+/*
+//  Chinese remainder reconstruction.
+//     - Garner: mixed radix digits v with value = v0 + v1*p0 + v2*p0*p1 + ...
+//     - Above (M-1)/2 the value is negative; (M-1)/2 has mixed radix
+//       digits (p_i - 1)/2, so the sign is a digit-wise comparison
+//     - Horner over the mixed radix digits with native multiply/add
+*/
+BigInt RnsBigInt::to_bigint() const{
+  const vector<uint32_t> &p = basis->primes;
+  size_t k = p.size();
+  vector<uint32_t> v(k);
+  
+  for(size_t i = 0; i < k; i++) {
+    uint64_t x = residues[i];
+    for(size_t j = 0; j < i; j++) {
+      x = (x + p[i] - v[j] % p[i]) % p[i];
+      x = x * basis->inverse[i][j] % p[i];
+    }
+    v[i] = x;
+  }
+  
+  //sign
+  bool negative = false;
+  for(size_t i = k; i-- > 0; ) {
+    uint32_t half = (p[i] - 1) / 2;
+    if(v[i] != half) {
+      negative = v[i] > half;
+      break;
+    }
+  }
+  
+  //magnitude: M - value = (M - 1 - value) + 1, digits p_i - 1 - v_i
+  if(negative) {
+    for(size_t i = 0; i < k; i++) {
+      v[i] = p[i] - 1 - v[i];
+    }
+  }
+  
+  BigInt result(0, base);
+  for(size_t i = k; i-- > 0; ) {
+    result *= p[i];
+    result += v[i];
+  }
+  if(negative) {
+    result += 1;
+    result.isPositive = false;
+  }
+  return result;
+}
+
+/*
+//  Number of primes in use.
+*/
+size_t RnsBigInt::moduli() const{
+  return residues.size();
+}
+
+/*
+//  Both operands must use the same primes.
+*/
+void RnsBigInt::checkBasis(const RnsBigInt &b) const{
+    if(basis != b.basis){
+        throw DiffRnsBasisException();
+    }
+}
+
+/*
+//==================
+// MEMBER function
+//==================
+*/
+const RnsBigInt & RnsBigInt::operator += (const RnsBigInt &b){
+  checkBasis(b);
+  const vector<uint32_t> &p = basis->primes;
+  
+  for(size_t i = 0; i < residues.size(); i++) {
+    uint32_t sum = residues[i] + b.residues[i];
+    residues[i] = sum >= p[i] ? sum - p[i] : sum;
+  }
+  return *this;
+}
+
+const RnsBigInt & RnsBigInt::operator -= (const RnsBigInt &b){
+  checkBasis(b);
+  const vector<uint32_t> &p = basis->primes;
+  
+  for(size_t i = 0; i < residues.size(); i++) {
+    uint32_t diff = residues[i] - b.residues[i];
+    residues[i] = residues[i] < b.residues[i] ? diff + p[i] : diff;
+  }
+  return *this;
+}
+
+const RnsBigInt & RnsBigInt::operator *= (const RnsBigInt &b){
+  checkBasis(b);
+  const vector<uint32_t> &p = basis->primes;
+  
+  for(size_t i = 0; i < residues.size(); i++) {
+    residues[i] = (uint64_t)residues[i] * b.residues[i] % p[i];
+  }
+  return *this;
+}
+
+bool RnsBigInt::operator == (const RnsBigInt &b) const{
+  checkBasis(b);
+  return residues == b.residues;
+}
+
+bool RnsBigInt::operator != (const RnsBigInt &b) const{
+  return !(*this == b);
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+RnsBigInt operator + (const RnsBigInt &a, const RnsBigInt &b){
+  RnsBigInt c(a);
+  c += b;
+  return c;
+}
+
+RnsBigInt operator - (const RnsBigInt &a, const RnsBigInt &b){
+  RnsBigInt c(a);
+  c -= b;
+  return c;
+}
+
+RnsBigInt operator * (const RnsBigInt &a, const RnsBigInt &b){
+  RnsBigInt c(a);
+  c *= b;
+  return c;
+}
+
+//******************************************************************
+//END OF THE RESIDUE NUMBER SYSTEM SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE ASYNCHRONOUS OPERATIONS SECTION
+//******************************************************************
+
+/*
+// Create a token that has not been cancelled.
+*/
+CancellationToken::CancellationToken(){
+  flag = make_shared< atomic<bool> >(false);
+}
+
+void CancellationToken::cancel(){
+  flag->store(true);
+}
+
+bool CancellationToken::cancelled() const{
+  return flag->load(memory_order_relaxed);
+}
+
+/*
+//  Run work on the executor (or a new detached thread) with the token
+//  and callback installed, and deliver its result or exception through
+//  a future.
+*/
+template<class R> static future<R> launchAsync(function<R()> work, CancellationToken token, ProgressCallback progress, Executor executor){
+  shared_ptr< promise<R> > result = make_shared< promise<R> >();
+  future<R> f = result->get_future();
+  
+  function<void()> task = [work, token, progress, result]() {
+    AsyncContext context;
+    context.token = token;
+    context.progress = progress;
+    context.depth = 0;
+    AsyncContext *outer = currentAsync;
+    currentAsync = &context;
+    
+    try {
+      checkCancelled();
+      if(progress) {
+        progress(0);
+      }
+      R value = work();
+      if(progress) {
+        progress(1);
+      }
+      result->set_value(value);
+    }
+    catch(...) {
+      result->set_exception(current_exception());
+    }
+    currentAsync = outer;
+  };
+  
+  if(executor) {
+    executor(task);
+  }
+  else {
+    thread(task).detach();
+  }
+  return f;
+}
+
+future<BigInt> mul_async(const BigInt &a, const BigInt &b, CancellationToken token, ProgressCallback progress, Executor executor){
+  return launchAsync<BigInt>([a, b]() { return a * b; }, token, progress, executor);
+}
+
+future<BigInt> pow_async(const BigInt &a, const BigInt &b, CancellationToken token, ProgressCallback progress, Executor executor){
+  return launchAsync<BigInt>([a, b]() { return pow(a, b); }, token, progress, executor);
+}
+
+future<BigInt> modPow_async(const BigInt &a, const BigInt &b, const BigInt &m, CancellationToken token, ProgressCallback progress, Executor executor){
+  return launchAsync<BigInt>([a, b, m]() { return modPow(a, b, m); }, token, progress, executor);
+}
+
+future<string> to_string_async(const BigInt &a, CancellationToken token, ProgressCallback progress, Executor executor){
+  return launchAsync<string>([a]() { return a.to_string(); }, token, progress, executor);
+}
+
+//******************************************************************
+//END OF THE ASYNCHRONOUS OPERATIONS SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE MEMORY-MAPPED SECTION
+//	File layout: one header page (MappedHeader), then the digits, least
+//	significant first, one byte each.
+//******************************************************************
+
+struct MappedHeader {
+  uint32_t magic;
+  int32_t base;
+  int32_t negative;
+  int32_t unused;
+  uint64_t length;
+};
+
+static const uint32_t MAPPED_MAGIC = 0x42494731;	//"BIG1"
+static const size_t MAPPED_HEADER = 4096;
+
+//Default budget for the out-of-core operations: 256 MB.
+static atomic<size_t> mappedWorkingSet((size_t)256 << 20);
+
+void MappedBigInt::set_working_set(size_t bytes){
+  mappedWorkingSet.store(bytes);
+}
+
+size_t MappedBigInt::working_set(){
+  return mappedWorkingSet.load();
+}
+
+/*
+// Create a zero in a new file (an existing file is replaced).
+*/
+MappedBigInt::MappedBigInt(const string &setpath, int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  path = setpath;
+  openFile(O_RDWR | O_CREAT | O_TRUNC);
+  
+  try {
+    MappedHeader *header = (MappedHeader *)map;
+    header->magic = MAPPED_MAGIC;
+    header->base = setbase;
+    header->negative = 0;
+    reserve(1);
+    digits()[0] = 0;
+    setLength(1);
+  }
+  catch(...) {
+    closeFile();
+    throw;
+  }
+}
+
+/*
+// Create a copy of b in a new file.
+*/
+MappedBigInt::MappedBigInt(const string &setpath, const BigInt &b){
+  path = setpath;
+  openFile(O_RDWR | O_CREAT | O_TRUNC);
+  
+  try {
+    MappedHeader *header = (MappedHeader *)map;
+    header->magic = MAPPED_MAGIC;
+    header->base = b.base;
+    
+    vector<int> d(b.vec);
+    trimDigits(d);
+    reserve(d.size());
+    for(size_t i = 0; i < d.size(); i++) {
+      digits()[i] = d[i];
+    }
+    setLength(d.size());
+    setNegative(!b.isPositive);
+  }
+  catch(...) {
+    closeFile();
+    throw;
+  }
+}
+
+/*
+// Open a file written by another MappedBigInt.
+*/
+MappedBigInt::MappedBigInt(const string &setpath){
+  path = setpath;
+  openFile(O_RDWR);
+  
+  try {
+    MappedHeader *header = (MappedHeader *)map;
+    if(header->magic != MAPPED_MAGIC || header->base < 2 || header->base > 36) {
+      throw MappedFileException();
+    }
+    reserve(size());
+  }
+  catch(...) {
+    closeFile();
+    throw;
+  }
+}
+
+MappedBigInt::~MappedBigInt(){
+  closeFile();
+}
+
+/*
+//  Unmap and close. The constructors call this themselves when they
+//  throw after openFile, since the destructor will not run.
+*/
+void MappedBigInt::closeFile(){
+  munmap(map, mapped);
+  close(fd);
+}
+
+/*
+//  Open the file and map the header page (plus whatever is already there).
+*/
+void MappedBigInt::openFile(int flags){
+  fd = ::open(path.c_str(), flags, 0644);
+  if(fd < 0) {
+    throw MappedFileException();
+  }
+  
+  struct stat info;
+  fstat(fd, &info);
+  mapped = max((size_t)info.st_size, MAPPED_HEADER);
+  if((size_t)info.st_size < mapped && ftruncate(fd, mapped) != 0) {
+    close(fd);
+    throw MappedFileException();
+  }
+  
+  void *p = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if(p == MAP_FAILED) {
+    close(fd);
+    throw MappedFileException();
+  }
+  map = (unsigned char *)p;
+}
+
+/*
+//  Grow the file and the mapping to hold at least n digits.
+//  Grows geometrically so repeated carries do not remap every time.
+//  The old mapping is released only once the new one exists, so a
+//  failure leaves the object as it was.
+*/
+void MappedBigInt::reserve(size_t n){
+  if(MAPPED_HEADER + n <= mapped) {
+    return;
+  }
+  size_t bytes = max(MAPPED_HEADER + n, 2 * mapped);
+  
+  if(ftruncate(fd, bytes) != 0) {
+    throw MappedFileException();
+  }
+  void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if(p == MAP_FAILED) {
+    throw MappedFileException();
+  }
+  munmap(map, mapped);
+  map = (unsigned char *)p;
+  mapped = bytes;
+}
+
+unsigned char * MappedBigInt::digits() const{
+  return map + MAPPED_HEADER;
+}
+
+void MappedBigInt::setLength(size_t length){
+  ((MappedHeader *)map)->length = length;
+}
+
+void MappedBigInt::setNegative(bool negative){
+  unsigned char *d = digits();
+  bool zero = size() == 1 && d[0] == 0;
+  ((MappedHeader *)map)->negative = negative && !zero;
+}
+
+size_t MappedBigInt::size() const{
+  return ((MappedHeader *)map)->length;
+}
+
+bool MappedBigInt::is_negative() const{
+  return ((MappedHeader *)map)->negative != 0;
+}
+
+int MappedBigInt::get_base() const{
+  return ((MappedHeader *)map)->base;
+}
+
+/*
+//  Drop digits [from, to) from memory once a pass is done with them.
+//  Dirty pages are written back first; the file keeps the data.
+*/
+void MappedBigInt::release(size_t from, size_t to) const{
+  size_t page = sysconf(_SC_PAGESIZE);
+  size_t start = (MAPPED_HEADER + from + page - 1) / page * page;
+  size_t end = (MAPPED_HEADER + to) / page * page;
+  
+  if(end > start) {
+    msync(map + start, end - start, MS_ASYNC);
+    madvise(map + start, end - start, MADV_DONTNEED);
+  }
+}
+
+/*
+//  Load the whole value into a BigInt.
+*/
+BigInt MappedBigInt::to_bigint() const{
+  BigInt result(get_base());
+  unsigned char *d = digits();
+  
+  result.vec = vector<int>(d, d + size());
+  result.isPositive = !is_negative();
+  return result;
+}
+
+/*
+//  Compare |a| and |b| from the top digit down.
+*/
+int MappedBigInt::compareMagnitudes(const MappedBigInt &a, const MappedBigInt &b){
+  if(a.size() != b.size()) {
+    return a.size() < b.size() ? -1 : 1;
+  }
+  unsigned char *da = a.digits();
+  unsigned char *db = b.digits();
+  for(size_t i = a.size(); i-- > 0; ) {
+    if(da[i] != db[i]) {
+      return da[i] < db[i] ? -1 : 1;
+    }
+  }
+  return 0;
+}
+
+/*
+//  |out| = |a| + |b|, one streaming pass. out may be a or b.
+*/
+void MappedBigInt::addMagnitudes(const MappedBigInt &a, const MappedBigInt &b, MappedBigInt &out){
+  size_t na = a.size();
+  size_t nb = b.size();
+  size_t n = max(na, nb);
+  size_t chunk = max(working_set() / 3, (size_t)1 << 16);
+  int base = out.get_base();
+  
+  out.reserve(n + 1);
+  unsigned char *da = a.digits();
+  unsigned char *db = b.digits();
+  unsigned char *dout = out.digits();
+  int carry = 0;
+  
+  for(size_t i = 0; i < n; i++) {
+    int cur = carry;
+    if(i < na) {
+      cur += da[i];
+    }
+    if(i < nb) {
+      cur += db[i];
+    }
+    carry = 0;
+    if(cur >= base) {
+      cur -= base;
+      carry = 1;
+    }
+    dout[i] = cur;
+    
+    if((i + 1) % chunk == 0) {
+      checkCancelled();
+      a.release(i + 1 - chunk, i + 1);
+      b.release(i + 1 - chunk, i + 1);
+      out.release(i + 1 - chunk, i + 1);
+    }
+  }
+  if(carry != 0) {
+    dout[n] = carry;
+    n++;
+  }
+  out.setLength(n);
+}
+
+/*
+//  |out| = |a| - |b| for |a| >= |b|, one streaming pass. out may be a or b.
+*/
+void MappedBigInt::subMagnitudes(const MappedBigInt &a, const MappedBigInt &b, MappedBigInt &out){
+  size_t na = a.size();
+  size_t nb = b.size();
+  size_t chunk = max(working_set() / 3, (size_t)1 << 16);
+  int base = out.get_base();
+  
+  out.reserve(na);
+  unsigned char *da = a.digits();
+  unsigned char *db = b.digits();
+  unsigned char *dout = out.digits();
+  int borrow = 0;
+  
+  for(size_t i = 0; i < na; i++) {
+    int cur = da[i] - borrow;
+    if(i < nb) {
+      cur -= db[i];
+    }
+    borrow = 0;
+    if(cur < 0) {
+      cur += base;
+      borrow = 1;
+    }
+    dout[i] = cur;
+    
+    if((i + 1) % chunk == 0) {
+      checkCancelled();
+      a.release(i + 1 - chunk, i + 1);
+      b.release(i + 1 - chunk, i + 1);
+      out.release(i + 1 - chunk, i + 1);
+    }
+  }
+  
+  //drop leading zeros
+  size_t n = na;
+  while(n > 1 && dout[n-1] == 0) {
+    n--;
+  }
+  out.setLength(n);
+}
+
+/*
+//  out = a + b, or a - b when negateB. Same sign rules as BigInt.
+*/
+void MappedBigInt::addSigned(const MappedBigInt &a, const MappedBigInt &b, bool negateB, MappedBigInt &out){
+    if(a.get_base() != b.get_base() || a.get_base() != out.get_base()){
+        throw DiffBaseException();
+    }
+  
+  bool nega = a.is_negative();
+  bool negb = b.is_negative() != negateB;
+  
+  if(nega == negb) {
+    addMagnitudes(a, b, out);
+    out.setNegative(nega);
+  }
+  else if(compareMagnitudes(a, b) >= 0) {
+    subMagnitudes(a, b, out);
+    out.setNegative(nega);
+  }
+  else {
+    subMagnitudes(b, a, out);
+    out.setNegative(negb);
   }
+}
+
+void MappedBigInt::add(const MappedBigInt &a, const MappedBigInt &b, MappedBigInt &out){
+  addSigned(a, b, false, out);
+}
+
+void MappedBigInt::subtract(const MappedBigInt &a, const MappedBigInt &b, MappedBigInt &out){
+  addSigned(a, b, true, out);
+}
+
+/*
+//  out = a * b, blocked so only two operand blocks and their product
+//  are in memory at a time.
+//     - Block size: about working_set() / 40 digits, since a block
+//       pair, its product and the Karatsuba temporaries take roughly
+//       40 bytes per block digit as ints
+//     - For every pair of blocks (i, j), Karatsuba multiply them and add
+//       the product into out at digit (i + j) * block
+//    out must be a different file from a and b.
+*/
+void MappedBigInt::multiply(const MappedBigInt &a, const MappedBigInt &b, MappedBigInt &out){
+    if(a.get_base() != b.get_base() || a.get_base() != out.get_base()){
+        throw DiffBaseException();
+    }
+    if(&out == &a || &out == &b){
+        throw MappedFileException();
+    }
   
-  if((!isPositive && (*this) > b)) {
-    avec = b - *this;
-    *this = avec;
-    isPositive = true;
-    return *this;
+  int base = out.get_base();
+  size_t na = a.size();
+  size_t nb = b.size();
+  size_t block = max(working_set() / 40, KARATSUBA_THRESHOLD);
+  
+  //clear the output
+  out.reserve(na + nb);
+  unsigned char *dout = out.digits();
+  for(size_t i = 0; i < na + nb; i += block) {
+    size_t end = min(na + nb, i + block);
+    memset(dout + i, 0, end - i);
+    out.release(i, end);
   }
-    
-  unsigned int size  = max(vec.size(), b.vec.size());
-  int val;
-  int valb;
   
-  for(unsigned int i = 0; i < size; i++) {
+  unsigned char *da = a.digits();
+  unsigned char *db = b.digits();
+  vector<int> blockA;
+  vector<int> blockB;
+  vector<int> product;
+  
+  for(size_t i = 0; i < na; i += block) {
+    size_t ea = min(na, i + block);
+    blockA.assign(da + i, da + ea);
+    a.release(i, ea);
     
-    if(i < vec.size()) {
-      val = vec[i];
-    }
-    else {
-      val = 0;
+    for(size_t j = 0; j < nb; j += block) {
+      checkCancelled();
+      size_t eb = min(nb, j + block);
+      blockB.assign(db + j, db + eb);
+      b.release(j, eb);
+      
+      mulDigits(blockA.data(), blockA.size(), blockB.data(), blockB.size(), base, product);
+      
+      //add the product in at digit i + j
+      int carry = 0;
+      size_t k = 0;
+      for(; k < product.size(); k++) {
+        int cur = dout[i + j + k] + product[k] + carry;
+        carry = 0;
+        if(cur >= base) {
+          cur -= base;
+          carry = 1;
+        }
+        dout[i + j + k] = cur;
+      }
+      for(k += i + j; carry != 0; k++) {
+        int cur = dout[k] + carry;
+        carry = 0;
+        if(cur >= base) {
+          cur -= base;
+          carry = 1;
+        }
+        dout[k] = cur;
+      }
+      out.release(i + j, i + j + product.size());
     }
-    
-    if(i < b.vec.size()) {
-      valb = b.vec[i];
+  }
+  
+  size_t n = na + nb;
+  while(n > 1 && dout[n-1] == 0) {
+    n--;
+  }
+  out.setLength(n);
+  out.setNegative(a.is_negative() != b.is_negative());
+}
+
+//******************************************************************
+//END OF THE MEMORY-MAPPED SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE PRODUCT TREE SECTION
+//	Balanced product and remainder trees (Bernstein). Level 0 holds
+//	the inputs and each level above holds the products of adjacent
+//	pairs, so every multiplication and division is between operands
+//	of similar size and the whole batch costs O(M(n) log n).
+//******************************************************************
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+//  Euclid's algorithm; the result is never negative.
+*/
+BigInt gcd(const BigInt &a, const BigInt &b){
+    if(a.get_base() != b.get_base()){
+        return gcd(a, mixedBase(b, a.get_base()));
     }
-    else {
-      valb = 0;
+  
+  BigInt x(a);
+  BigInt y(b);
+  if(x.sign() < 0) {
+    x *= -1;
+  }
+  if(y.sign() < 0) {
+    y *= -1;
+  }
+  while(!y.is_zero()) {
+    checkCancelled();
+    x %= y;
+    swap(x, y);
+  }
+  if(x.is_zero()) {
+    return baseConstants(a.get_base()).zero;
+  }
+  return x;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+//  tree[0] = values, tree[k+1][i] = tree[k][2i] * tree[k][2i+1];
+//  an odd last entry moves up unchanged. The root is tree.back()[0].
+*/
+vector<vector<BigInt> > product_tree(const vector<BigInt> &values){
+  vector<vector<BigInt> > tree(1, values);
+  
+  while(tree.back().size() > 1) {
+    const vector<BigInt> &below = tree.back();
+    vector<BigInt> level;
+    level.reserve((below.size() + 1) / 2);
+    for(size_t i = 0; i + 1 < below.size(); i += 2) {
+      level.push_back(below[i] * below[i+1]);
     }
-    
-    difference = val - valb - borrow;
-    borrow = 0;
-    if(difference < 0) {
-      difference += base;
-      borrow++;
+    if(below.size() % 2 == 1) {
+      level.push_back(below.back());
     }
-    
-    if(i < vec.size()) {
-       vec[i] = difference;
-     }
-     else {
-       vec.push_back(difference);
-     }
+    tree.push_back(level);
   }
-  
-  //remove all leading zeros
-  for(int i = vec.size()-1; i >= 0; i--) {
-    if(vec[i] == 0) {
-      vec.pop_back();
+  return tree;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+//  n % moduli[i] for every i, by reducing n modulo each node of the
+//  product tree on the way down. Same sign rules as operator %.
+*/
+vector<BigInt> remainder_tree(const BigInt &n, const vector<BigInt> &moduli){
+  if(moduli.empty()) {
+    return vector<BigInt>();
   }
-    else {
-      break;
+  
+  vector<vector<BigInt> > tree = product_tree(moduli);
+  vector<BigInt> rems(1, n % tree.back()[0]);
+  
+  for(size_t k = tree.size() - 1; k-- > 0; ) {
+    const vector<BigInt> &level = tree[k];
+    vector<BigInt> next;
+    next.reserve(level.size());
+    for(size_t i = 0; i < level.size(); i++) {
+      next.push_back(rems[i / 2] % level[i]);
     }
+    rems.swap(next);
   }
-  
-  return *this;
+  return rems;
 }
 
 /*
 //======================
 // NON-MEMBER function
 //======================
+//  gcd(values[i], product of all the other values) for every i
+//  (Bernstein's batch GCD), e.g. to find moduli sharing a factor.
+//  The values must be non-zero.
+//     - Reduce the root product P modulo the square of each node going
+//       down, so the leaves get z_i = P mod x_i^2
+//     - z_i / x_i = (P / x_i) mod x_i, whose gcd with x_i is the answer
 */
-BigInt operator * (const  BigInt &a, const BigInt & b){
+vector<BigInt> batch_gcd(const vector<BigInt> &values){
+  if(values.empty()) {
+    return vector<BigInt>();
+  }
+  
+  vector<vector<BigInt> > tree = product_tree(values);
+  vector<BigInt> rems(1, tree.back()[0]);
+  
+  for(size_t k = tree.size() - 1; k-- > 0; ) {
+    const vector<BigInt> &level = tree[k];
+    vector<BigInt> next;
+    next.reserve(level.size());
+    for(size_t i = 0; i < level.size(); i++) {
+      next.push_back(rems[i / 2] % square(level[i]));
+    }
+    rems.swap(next);
+  }
+  
+  vector<BigInt> result;
+  result.reserve(values.size());
+  for(size_t i = 0; i < values.size(); i++) {
+    result.push_back(gcd(divexact(rems[i], values[i]), values[i]));
+  }
+  return result;
+}
 
-  BigInt c(b);
-  c *= a;
-  return c;
+//******************************************************************
+//END OF THE PRODUCT TREE SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE RANDOM SECTION
+//	Random values are built as 32-bit words and converted with
+//	wordsToDigits, so a draw costs one radix conversion rather than a
+//	multiply and add per word.
+//******************************************************************
 
+static uint64_t splitMix(uint64_t z){
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
 }
 
 /*
-//==================
-// MEMBER function
-//==================
+// Each stream gets its own odd step, so streams of one seed never
+// walk the same counter sequence.
 */
-const BigInt & BigInt::operator *= (const BigInt &b){
-    if(base != b.base){
-        throw DiffBaseException();
+CounterRng::CounterRng(uint64_t seed, uint64_t stream){
+  key = splitMix(seed + 0x9E3779B97F4A7C15ULL);
+  gamma = splitMix(stream ^ 0x6A09E667F3BCC909ULL) | 1;
+  counter = 0;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+*/
+BigInt from_words(const vector<uint32_t> &words, int base){
+    if(base < 2 || base > 36){
+        throw InvalidBaseException();
+    }
+  
+  BigInt result(base);
+  vector<int> &d = result.vec.write();
+  wordsToDigits(words, base, d);
+  if(d.empty()) {
+    d.push_back(0);
+  }
+  return result;
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+//  Draw bit_length(bound) bits from the top word down and stop at the
+//  first word that differs from bound: below means accept (the rest is
+//  drawn freely), above means start over. Each attempt succeeds with
+//  probability over 1/2 and most rejections cost a single word.
+*/
+BigInt random_below(const BigInt &bound, const WordSource &source){
+    if(bound.sign() <= 0){
+        throw InvalidBoundException();
+    }
+  
+  vector<uint32_t> limit;
+  digitsToWords(bound.vec, bound.base, limit);
+  size_t n = limit.size();
+  uint32_t mask = UINT32_MAX;
+  while((mask >> 1) >= limit[n-1]) {
+    mask >>= 1;
+  }
+  
+  vector<uint32_t> words(n);
+  while(true) {
+    size_t i = n;
+    bool below = false;
+    while(i-- > 0) {
+      source(&words[i], 1);
+      if(i == n - 1) {
+        words[i] &= mask;
+      }
+      if(words[i] != limit[i]) {
+        below = words[i] < limit[i];
+        break;
+      }
     }
+    if(below) {
+      source(words.data(), i);
+      return from_words(words, bound.base);
+    }
+  }
+}
 
-  //zero
-  if(b.to_int() == 0) {
-    *this = b;
-    return *this;
+/*
+// Run fill(i) for every i < count on up to threads threads, each thread
+// taking a contiguous block of indices.
+*/
+static void parallelFill(size_t count, unsigned threads, const function<void(size_t)> &fill){
+  if(threads == 0) {
+    threads = thread::hardware_concurrency();
   }
-  if(to_int() == 0) {
-    for(unsigned int i = 0; i < vec.size(); i++){
+  if(threads == 0) {
+    threads = 1;
+  }
+  threads = (unsigned)min((size_t)threads, count);
+  
+  if(threads <= 1) {
+    for(size_t i = 0; i < count; i++) {
+      fill(i);
     }
-    return *this;
+    return;
   }
   
-  //one
-  if(b.to_int() == 1) {
-    return *this;
+  vector<thread> workers;
+  for(unsigned t = 0; t < threads; t++) {
+    size_t first = count * t / threads;
+    size_t last = count * (t + 1) / threads;
+    workers.push_back(thread([&fill, first, last]() {
+      for(size_t i = first; i < last; i++) {
+        fill(i);
+      }
+    }));
   }
-  if(to_int() == 1) {
-    *this = b;
-    return *this;
+  for(unsigned t = 0; t < threads; t++) {
+    workers[t].join();
   }
+}
+
+/*
+//======================
+// NON-MEMBER function
+//======================
+//  out[i] = random_bits(bits, CounterRng(seed, i), base)
+*/
+void random_fill(vector<BigInt> &out, size_t bits, uint64_t seed, int base, unsigned threads){
+    if(base < 2 || base > 36){
+        throw InvalidBaseException();
+    }
   
-  //is result negative
-  bool neg = isPositive == b.isPositive;
+  parallelFill(out.size(), threads, [&](size_t i) {
+    CounterRng rng(seed, i);
+    out[i] = random_bits(bits, rng, base);
+  });
+}
 
-  int carry = 0;
-  vector<int> result;
-  int product;
+/*
+//======================
+// NON-MEMBER function
+//======================
+//  out[i] = random_below(bound, CounterRng(seed, i))
+*/
+void random_fill(vector<BigInt> &out, const BigInt &bound, uint64_t seed, unsigned threads){
+    if(bound.sign() <= 0){
+        throw InvalidBoundException();
+    }
   
-  int maxdig = max(vec.size(), b.vec.size());
-  maxdig *= 2;
+  parallelFill(out.size(), threads, [&](size_t i) {
+    CounterRng rng(seed, i);
+    out[i] = random_below(bound, rng);
+  });
+}
+
+//******************************************************************
+//END OF THE RANDOM SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE PACKED ARRAY SECTION
+//	BigIntArray keeps digits most significant first so that two
+//	magnitudes of the same length compare with one memcmp.
+//	Elements that shrink are rewritten in place; elements that grow
+//	move to the end of the buffer, and compact() (run automatically
+//	once half the buffer is unused) closes the gaps.
+//******************************************************************
+
+BigIntView::BigIntView(const unsigned char *d, size_t n, bool neg, int setbase){
+  digits = d;
+  length = n;
+  negative = neg;
+  base = setbase;
+}
+
+size_t BigIntView::size() const{
+  return length;
+}
+
+bool BigIntView::is_negative() const{
+  return negative;
+}
+
+/*
+//  Compare by value: sign, then length, then digits from the top.
+*/
+int BigIntView::compare(const BigIntView &b) const{
+  if(negative != b.negative) {
+    return negative ? -1 : 1;
+  }
+  int cmp = 0;
+  if(length != b.length) {
+    cmp = length < b.length ? -1 : 1;
+  }
+  else {
+    int diff = memcmp(digits, b.digits, length);
+    cmp = (diff > 0) - (diff < 0);
+  }
+  return negative ? -cmp : cmp;
+}
+
+BigInt BigIntView::to_bigint() const{
+  BigInt result(base);
+  vector<int> &d = result.vec.write();
+  d.resize(length);
+  for(size_t t = 0; t < length; t++) {
+    d[t] = digits[length - 1 - t];
+  }
+  result.isPositive = !negative;
+  return result;
+}
+
+BigIntArray::BigIntArray(int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  base = setbase;
+  garbage = 0;
+}
+
+BigIntArray::BigIntArray(const vector<BigInt> &values, int setbase){
+    if(setbase < 2 || setbase > 36){
+        throw InvalidBaseException();
+    }
+  base = setbase;
+  garbage = 0;
   
-  for(int i = 0; i < maxdig; i++) {
-    result.push_back(0);
+  size_t total = 0;
+  for(size_t i = 0; i < values.size(); i++) {
+    total += values[i].vec.size();
+  }
+  reserve(values.size(), total);
+  for(size_t i = 0; i < values.size(); i++) {
+    push_back(values[i]);
+  }
+}
+
+void BigIntArray::reserve(size_t count, size_t totalDigits){
+  digits.reserve(totalDigits);
+  offsets.reserve(count);
+  lengths.reserve(count);
+  negative.reserve(count);
+}
+
+void BigIntArray::clear(){
+  digits.clear();
+  offsets.clear();
+  lengths.clear();
+  negative.clear();
+  garbage = 0;
+}
+
+size_t BigIntArray::size() const{
+  return offsets.size();
+}
+
+bool BigIntArray::empty() const{
+  return offsets.empty();
+}
+
+int BigIntArray::get_base() const{
+  return base;
+}
+
+void BigIntArray::push_back(const BigInt &b){
+  if(b.base != base) {
+    push_back(mixedBase(b, base));
+    return;
   }
+  offsets.push_back(digits.size());
+  lengths.push_back(0);
+  negative.push_back(0);
+  store(offsets.size() - 1, b);
+}
+
+BigIntView BigIntArray::operator [] (size_t i) const{
+  return BigIntView(digits.data() + offsets[i], lengths[i], negative[i] != 0, base);
+}
+
+BigInt BigIntArray::get(size_t i) const{
+  BigInt result(base);
+  load(i, result);
+  return result;
+}
+
+void BigIntArray::set(size_t i, const BigInt &b){
+  store(i, b);
+}
+
+/*
+//  Read element i into out, reusing out's digit storage.
+*/
+void BigIntArray::load(size_t i, BigInt &out) const{
+  const unsigned char *d = digits.data() + offsets[i];
+  size_t n = lengths[i];
+  vector<int> &v = out.vec.write();
   
-  for(unsigned int i = 0; i <vec.size(); i++) {
-    for(unsigned int k =0; k<b.vec.size(); k++) {
-      product = vec[i]*b.vec[k] + carry;
-      carry = product/base;
-      
-      if(product >= base) {
-        product = product%base;   
-      } 
+  v.resize(n);
+  for(size_t t = 0; t < n; t++) {
+    v[t] = d[n - 1 - t];
+  }
+  out.base = base;
+  out.isPositive = negative[i] == 0;
+}
 
-      result[k+i] += product;
-      
-      if(k == b.vec.size()-1) {
-        if(carry != 0) {
-          result[k+i+1] += carry;
-          carry = 0;
-        }
-      }
+/*
+//  Write b into element i: in place when it fits, otherwise at the end.
+*/
+void BigIntArray::store(size_t i, const BigInt &b){
+    if(b.base != base){
+        store(i, mixedBase(b, base));
+        return;
     }
-  } 
   
-  //single digits in each vector index
-  for(unsigned int i = 0; i < result.size(); i++) {
-    if(result[i] >= base) {
-      int temp = result[i];
-      result[i] %= base;
-      result[i+1] += temp/base;
+  const vector<int> &v = b.vec;
+  size_t n = v.size();
+  while(n > 1 && v[n-1] == 0) {
+    n--;
+  }
+  
+  if(n == 0) {
+    //default-constructed zero
+    if(lengths[i] == 0) {
+      offsets[i] = digits.size();
+      digits.push_back(0);
+    }
+    else {
+      garbage += lengths[i] - 1;
+      digits[offsets[i]] = 0;
     }
+    lengths[i] = 1;
+    negative[i] = 0;
+    return;
   }
   
-  //remove all leading zeros
-  for(int i = result.size()-1; i >= 0; i--) {
-    if(result[i] == 0) {
-      result.pop_back();
+  if(n <= lengths[i]) {
+    garbage += lengths[i] - n;
   }
-    else {
-      break;
-    }
+  else {
+    garbage += lengths[i];
+    offsets[i] = digits.size();
+    digits.resize(digits.size() + n);
   }
-     
-  vec = result;
-  this->isPositive = neg;
   
-  return *this;
+  unsigned char *d = digits.data() + offsets[i];
+  for(size_t t = 0; t < n; t++) {
+    d[t] = v[n - 1 - t];
+  }
+  lengths[i] = n;
+  negative[i] = !b.isPositive && !(n == 1 && v[0] == 0);
+  
+  if(garbage > digits.size() / 2) {
+    compact();
+  }
 }
 
 /*
-//======================
-// NON-MEMBER function
-//======================
+//  Rewrite the buffer with the elements back to back in index order.
 */
-BigInt operator / (const  BigInt &a, const BigInt & b){
-   
-  BigInt c = a;
-  c /= b;
+void BigIntArray::compact(){
+  vector<unsigned char> packed;
+  packed.reserve(digits.size() - garbage);
   
-  return c;
+  for(size_t i = 0; i < offsets.size(); i++) {
+    uint64_t start = packed.size();
+    packed.insert(packed.end(), digits.begin() + offsets[i], digits.begin() + offsets[i] + lengths[i]);
+    offsets[i] = start;
+  }
+  digits.swap(packed);
+  garbage = 0;
 }
 
-
 /*
-//==================
-// MEMBER function
-//==================
+//  Sort an index permutation by value, then lay the buffer out again in
+//  that order, which also compacts it.
 */
-const BigInt & BigInt::operator /= (const BigInt &b){
-    if(base != b.base){
-        throw DiffBaseException();
-    }
-    if(b.vec.size() == 1 && b.vec[0] == 0){
-        throw DivByZeroException();
-    }
-    
-  BigInt q;
-  BigInt r;
+void BigIntArray::sort(){
+  vector<size_t> order(offsets.size());
+  for(size_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  const BigIntArray &self = *this;
+  std::sort(order.begin(), order.end(), [&self](size_t x, size_t y){
+    return self[x].compare(self[y]) < 0;
+  });
   
-  q.base = base;
-  r.base = base;
-    
-  divisionMain(b, q, r);
-  *this = q;
- 
-  return *this;
+  vector<unsigned char> packed;
+  vector<uint64_t> newOffsets(order.size());
+  vector<uint64_t> newLengths(order.size());
+  vector<unsigned char> newNegative(order.size());
+  packed.reserve(digits.size() - garbage);
+  
+  for(size_t i = 0; i < order.size(); i++) {
+    size_t from = order[i];
+    newOffsets[i] = packed.size();
+    newLengths[i] = lengths[from];
+    newNegative[i] = negative[from];
+    packed.insert(packed.end(), digits.begin() + offsets[from], digits.begin() + offsets[from] + lengths[from]);
+  }
+  digits.swap(packed);
+  offsets.swap(newOffsets);
+  lengths.swap(newLengths);
+  negative.swap(newNegative);
+  garbage = 0;
 }
 
 /*
-//======================
-// NON-MEMBER function
-//======================
+//  Elementwise x op= b for every element x.
+//  op: 0 for +, 1 for -, 2 for *, 3 for %
 */
-BigInt operator % (const  BigInt &a, const BigInt & b){
+void BigIntArray::apply(const BigInt &b, int op){
+    if(b.base != base){
+        apply(mixedBase(b, base), op);
+        return;
+    }
   
-  BigInt c = a;
-  c %= b;
-  return c;
-
+  BigInt x(base);
+  for(size_t i = 0; i < offsets.size(); i++) {
+    load(i, x);
+    switch(op) {
+      case 0: x += b; break;
+      case 1: x -= b; break;
+      case 2: x *= b; break;
+      case 3: x %= b; break;
+    }
+    store(i, x);
+  }
 }
 
 /*
-//==================
-// MEMBER function
-//==================
+//  Elementwise x[i] op= b[i]; op as in apply.
 */
-const BigInt & BigInt::operator %= (const BigInt &b){
-    if(base != b.base){
-        throw DiffBaseException();
+void BigIntArray::applyArray(const BigIntArray &b, int op){
+    if(b.size() != size()){
+        throw SizeMismatchException();
     }
-    if(b.vec.size() == 1 && b.vec[0] == 0){
-        throw DivByZeroException();//divide by zero.
+  
+  BigInt x(base);
+  BigInt y(base);
+  for(size_t i = 0; i < offsets.size(); i++) {
+    load(i, x);
+    b.load(i, y);
+    switch(op) {
+      case 0: x += y; break;
+      case 1: x -= y; break;
+      case 2: x *= y; break;
     }
+    store(i, x);
+  }
+}
 
-  BigInt q;
-  BigInt r;
-  
-  q.base = base;
-  r.base = base;
-    
-  divisionMain(b, q, r);
-  *this = r;
+BigIntArray & BigIntArray::operator += (const BigInt &b){
+  apply(b, 0);
   return *this;
-  
 }
 
-/*
-//  Main function for the Division (/=) and Modulus (%=) operators.
-//     - Compute (q)uotient and (r)emainder
-//     - Implement Long Division
-*/
-void BigInt::divisionMain(const BigInt &b, BigInt &quotient, BigInt &remainder){
+BigIntArray & BigIntArray::operator -= (const BigInt &b){
+  apply(b, 1);
+  return *this;
+}
 
-//1
-  BigInt divisor(b);               
-  BigInt dividend(*this); 
-  bool sign = isPositive == b.isPositive;
-  bool startsign = isPositive;
-  dividend.isPositive = true;
-  divisor.isPositive = true;
+BigIntArray & BigIntArray::operator *= (const BigInt &b){
+  apply(b, 2);
+  return *this;
+}
 
-  
-  //divide by one
-  if(divisor.to_int() == 1) {
-    quotient = dividend;
-    quotient.isPositive = sign;
-    remainder.vec.push_back(0);
-    remainder.isPositive = true;
+BigIntArray & BigIntArray::operator %= (const BigInt &b){
+  apply(b, 3);
+  return *this;
+}
+
+BigIntArray & BigIntArray::operator += (const BigIntArray &b){
+  applyArray(b, 0);
+  return *this;
+}
+
+BigIntArray & BigIntArray::operator -= (const BigIntArray &b){
+  applyArray(b, 1);
+  return *this;
+}
+
+BigIntArray & BigIntArray::operator *= (const BigIntArray &b){
+  applyArray(b, 2);
+  return *this;
+}
+
+//******************************************************************
+//END OF THE PACKED ARRAY SECTION
+//******************************************************************
+
+//******************************************************************
+//START OF THE PARALLEL REDUCTION SECTION
+//	Copies of the inputs share digits, so the vector forms cost no
+//	digit copies. Chunk results are combined on the calling thread
+//	(sum, minmax) or level by level as further tasks (product).
+//******************************************************************
+
+//Chunks below this many digits are not worth a thread of their own.
+static const uint64_t PARALLEL_MIN_DIGITS = 1 << 14;
+
+/*
+// Run task(i) for every i < count and wait for all of them; the first
+// exception is rethrown. Task 0 runs on the calling thread, the rest
+// on the executor or on joined threads, and nothing is left running
+// when this returns or throws.
+*/
+static void runTasks(size_t count, const Executor &executor, const function<void(size_t)> &task){
+  if(count == 0) {
     return;
   }
+  vector<exception_ptr> errors(count);
+  function<void(size_t)> guarded = [&task, &errors](size_t i) {
+    try {
+      task(i);
+    }
+    catch(...) {
+      errors[i] = current_exception();
+    }
+  };
   
-  //divide by itself
-  if(divisor == dividend) {
-    quotient.vec.push_back(1);
-    quotient.isPositive = sign;
-    remainder.vec.push_back(0);
-    remainder.isPositive = true;
-    return;
+  if(!executor) {
+    vector<thread> workers;
+    try {
+      for(size_t i = 1; i < count; i++) {
+        workers.push_back(thread(guarded, i));
+      }
+    }
+    catch(...) {
+      //could not start every thread: run the rest here
+      for(size_t i = workers.size() + 1; i < count; i++) {
+        guarded(i);
+      }
+    }
+    guarded(0);
+    for(size_t i = 0; i < workers.size(); i++) {
+      workers[i].join();
+    }
   }
-  
-  //divide by a bigger number
-  if(dividend < divisor) {
-    quotient.vec.push_back(0);
-    quotient.isPositive = true;
-    remainder = *this;
-    return;
+  else {
+    //a task runs on whichever side claims it first; the flags outlive
+    //this call so a copy the executor runs late finds its task taken
+    vector< promise<void> > done(count);
+    vector< future<void> > waits;
+    shared_ptr< vector< atomic<bool> > > claimed = make_shared< vector< atomic<bool> > >(count);
+    for(size_t i = 1; i < count; i++) {
+      waits.push_back(done[i].get_future());
+      try {
+        executor([&guarded, &done, claimed, i]() {
+          if(!(*claimed)[i].exchange(true)) {
+            guarded(i);
+            done[i].set_value();
+          }
+        });
+      }
+      catch(...) {
+        //the executor threw: run the task here unless it already took it
+        if(!(*claimed)[i].exchange(true)) {
+          guarded(i);
+          done[i].set_value();
+        }
+      }
+    }
+    guarded(0);
+    for(size_t i = 0; i < waits.size(); i++) {
+      waits[i].wait();
+    }
   }
   
-  quotient.vec.clear();
-  remainder.vec.clear();
-  
-  
-  //find dividend sequence
-  int pos = vec.size()-1; 
-  BigInt dividend_seq(vec[pos], base);
-  
-  while(dividend_seq < divisor) {
-    pos--;
-    dividend_seq.vec.insert(dividend_seq.vec.begin(), vec[pos]);
-  }
-  while(pos >= 0) {
-    int times = 0;
-    while(dividend_seq >= divisor) {
-      dividend_seq -= divisor;
-      times++;
+  for(size_t i = 0; i < count; i++) {
+    if(errors[i]) {
+      rethrow_exception(errors[i]);
     }
+  }
+}
+
+/*
+// Split values into up to one chunk per hardware thread, and per
+// PARALLEL_MIN_DIGITS digits, with about the same number of digits each. Chunk t is [bounds[t], bounds[t+1]).
+*/
+static vector<size_t> chunkBounds(const vector<BigInt> &values){
+  uint64_t total = 0;
+  for(size_t i = 0; i < values.size(); i++) {
+    total += values[i].size();
+  }
   
-    //construct quotient
-     quotient.vec.insert(quotient.vec.begin(),times);
+  size_t chunks = thread::hardware_concurrency();
+  if(chunks == 0) {
+    chunks = 1;
+  }
+  chunks = min(chunks, values.size());
+  chunks = min(chunks, (size_t)(total / PARALLEL_MIN_DIGITS) + 1);
   
-    if(dividend_seq.vec.size() == 1 and dividend_seq.vec[0]== 0) {
-      dividend_seq.vec.clear();
-    }
-    
-    if(pos > 0) {
-      dividend_seq.vec.insert(dividend_seq.vec.begin(), vec[pos-1]);
+  vector<size_t> bounds(1, 0);
+  uint64_t seen = 0;
+  for(size_t i = 0; i < values.size() && bounds.size() < chunks; i++) {
+    seen += values[i].size();
+    if(seen * chunks >= total * bounds.size()) {
+      bounds.push_back(i + 1);
     }
-   
-    pos--;
-    
   }
+  if(bounds.back() != values.size()) {
+    bounds.push_back(values.size());
+  }
+  return bounds;
+}
 
- 
-  quotient.isPositive = sign;
+/*
+// Product of values[first, last), always multiplying the two smallest
+// operands left (by digit count).
+*/
+static BigInt huffmanProduct(const vector<BigInt> &values, size_t first, size_t last){
+  typedef pair<size_t, size_t> Entry;		//(digits, slot)
+  priority_queue<Entry, vector<Entry>, greater<Entry> > heap;
+  vector<BigInt> slots(values.begin() + first, values.begin() + last);
   
-  //dividend_seq EMPTY?
-  if(dividend_seq.vec.empty()) {
-      remainder.vec.push_back(0);
-      remainder.isPositive = true;
+  for(size_t i = 0; i < slots.size(); i++) {
+    if(slots[i].is_zero()) {
+      return slots[i];
+    }
+    heap.push(Entry(slots[i].size(), i));
   }
-  else {
-    remainder.vec = dividend_seq.vec;
-    remainder.isPositive = startsign;
+  while(heap.size() > 1) {
+    checkCancelled();
+    size_t x = heap.top().second;
+    heap.pop();
+    size_t y = heap.top().second;
+    heap.pop();
+    slots[x] *= slots[y];
+    slots[y] = BigInt(slots[x].get_base());
+    heap.push(Entry(slots[x].size(), x));
   }
-  return;
+  return slots[heap.top().second];
 }
 
 /*
 //======================
 // NON-MEMBER function
 //======================
+//  Each chunk is summed in a BigIntAccumulator; the chunk sums are then
+//  added on the calling thread.
 */
-BigInt pow(const  BigInt &a, const BigInt & b){
+BigInt parallel_sum(const vector<BigInt> &values, Executor executor){
+  if(values.empty()) {
+    return baseConstants(10).zero;
+  }
   
-  BigInt c(a);
-  c.exponentiation(b);
-  return c;
-
+  int base = values[0].get_base();
+  vector<size_t> bounds = chunkBounds(values);
+  vector<BigInt> partial(bounds.size() - 1);
+  runTasks(partial.size(), executor, [&](size_t t) {
+    BigIntAccumulator acc(base);
+    for(size_t i = bounds[t]; i < bounds[t+1]; i++) {
+      acc += values[i];
+    }
+    partial[t] = acc.value();
+  });
+  
+  BigIntAccumulator acc(base);
+  for(size_t t = 0; t < partial.size(); t++) {
+    acc += partial[t];
+  }
+  return acc.value();
 }
 
 /*
-//==================
-// MEMBER function
-//==================
+//======================
+// NON-MEMBER function
+//======================
+//  Smallest-pair-first product inside each chunk, then the chunk
+//  products are sorted by size and multiplied in neighbouring pairs,
+//  one task per pair, until one is left.
 */
-const BigInt & BigInt::exponentiation(const BigInt &b){
-    if(base != b.base){
-        throw DiffBaseException();
-    }
-    if(!b.isPositive){
-        throw ExpByNegativeException();
-    }
-
-  BigInt acopy(*this);
-  BigInt oddcopy;
-  BigInt bcopy(b);
-  
-  BigInt zero(0,base);
-  BigInt one(1,base);
-  BigInt two(2,base);
-  
-  oddcopy = one;
-  oddcopy.base = base;
-  
-  //b = 0
-  if(bcopy == zero) {
-    isPositive = true;
-    *this = one;
-    return *this;
+BigInt parallel_product(const vector<BigInt> &values, Executor executor){
+  if(values.empty()) {
+    return baseConstants(10).one;
   }
   
-  //b = 1
-  if(bcopy == one) {
-    return *this;
+  //bring every factor to the first one's base before splitting
+  int base = values[0].get_base();
+  vector<BigInt> converted;
+  for(size_t i = 1; i < values.size(); i++) {
+    if(values[i].get_base() != base) {
+      if(converted.empty()) {
+        converted = values;
+      }
+      converted[i] = mixedBase(values[i], base);
+    }
   }
+  const vector<BigInt> &factors = converted.empty() ? values : converted;
   
+  vector<size_t> bounds = chunkBounds(factors);
+  vector<BigInt> level(bounds.size() - 1);
+  runTasks(level.size(), executor, [&](size_t t) {
+    level[t] = huffmanProduct(factors, bounds[t], bounds[t+1]);
+  });
   
-  while(bcopy != one) {
-    if(bcopy%two == zero) {
-      acopy *= acopy;
-    }
-    
-    else if(bcopy%two == one) {
-      oddcopy *= acopy;
-      acopy *= acopy;
+  while(level.size() > 1) {
+    sort(level.begin(), level.end(), [](const BigInt &x, const BigInt &y) {
+      return x.size() < y.size();
+    });
+    vector<BigInt> next((level.size() + 1) / 2);
+    runTasks(level.size() / 2, executor, [&](size_t t) {
+      next[t] = level[2*t] * level[2*t+1];
+    });
+    if(level.size() % 2 == 1) {
+      next.back() = level.back();
     }
-    
-    bcopy/= two;
-    bcopy.base = b.base;
-    
+    level.swap(next);
   }
-  acopy *= oddcopy;
-  *this = acopy;
-  return *this;
-    
+  return level[0];
 }
 
 /*
 //======================
 // NON-MEMBER function
 //======================
+//  Smallest and largest of each chunk, then of the chunk results.
 */
-BigInt modPow(const BigInt &a, const BigInt &b, const BigInt &m){  
-
-  BigInt c(a);
-  c.modulusExp(b, m);
-  return c;
-
-}
- 
-
-/*
-//==================
-// MEMBER function
-//==================
-*/
-const BigInt & BigInt::modulusExp(const BigInt &b, const BigInt &m){
-    if(base != b.base || base != m.base){
-        throw DiffBaseException();
-    }
-    if(!b.isPositive){
-        throw ExpByNegativeException();
-    }
- 
-  BigInt acopy(*this);
-  BigInt oddcopy;
-  BigInt bcopy(b);
-  
-  BigInt zero(0,base);
-  BigInt one(1,base);
-  BigInt two(2,base);
-  
-  oddcopy = one;
-  oddcopy.base = base;
-  
-  //b = 0
-  if(bcopy == zero) {
-    isPositive = true;
-    *this = one;
-    return *this;
-  }
-  
-  //b = 1
-  if(bcopy == one) {
-    return *this;
+pair<BigInt, BigInt> parallel_minmax(const vector<BigInt> &values, Executor executor){
+  if(values.empty()) {
+    throw EmptyRangeException();
   }
   
+  vector<size_t> bounds = chunkBounds(values);
+  vector<size_t> low(bounds.size() - 1);
+  vector<size_t> high(bounds.size() - 1);
+  runTasks(low.size(), executor, [&](size_t t) {
+    low[t] = high[t] = bounds[t];
+    for(size_t i = bounds[t] + 1; i < bounds[t+1]; i++) {
+      if(values[i] < values[low[t]]) {
+        low[t] = i;
+      }
+      if(values[i] > values[high[t]]) {
+        high[t] = i;
+      }
+    }
+  });
   
-  while(bcopy != one) {
-    if(bcopy%two == zero) {
-      acopy *= acopy;
-      acopy %= m;
-      
+  size_t lowest = low[0];
+  size_t highest = high[0];
+  for(size_t t = 1; t < low.size(); t++) {
+    if(values[low[t]] < values[lowest]) {
+      lowest = low[t];
     }
-    else if(bcopy%two == one) {
-      oddcopy *= acopy;
-      acopy *= acopy;
-      acopy %=m; 
+    if(values[high[t]] > values[highest]) {
+      highest = high[t];
     }
-    
-    bcopy/= two;
-    bcopy.base = b.base;
-    
   }
-  
-  acopy *= oddcopy;
-  acopy %= m;
-  *this = acopy;
-
-  
-    return *this;
+  return make_pair(values[lowest], values[highest]);
 }
 
 //******************************************************************
-//END OF THE ARITHMETIC OPERATORS SECTION
+//END OF THE PARALLEL REDUCTION SECTION
 //******************************************************************
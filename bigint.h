@@ -1,8 +1,85 @@
 #include <string>
 #include <vector>
 #include <exception>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <limits>
+#include <random>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <utility>
 using namespace std;
 
+//===================================
+//DigitStore class definition
+//	Copy-on-write digit storage for BigInt. Copies share one block
+//	through an atomic reference count, so copying or passing a BigInt
+//	around is O(1); the digits are deep-copied only when a shared
+//	block is first modified.
+//	Reads (indexing, read()) never copy, even on a non-const store;
+//	digits are changed through write() and the mutating members,
+//	which detach first, so they always touch a private block.
+//===================================
+class DigitStore {
+
+	public:
+		typedef vector<int>::const_iterator const_iterator;
+
+		DigitStore();
+		DigitStore(const DigitStore &d);	//shares d's block
+		DigitStore(DigitStore &&d);
+		~DigitStore();
+		DigitStore & operator = (const DigitStore &d);
+		DigitStore & operator = (DigitStore &&d);
+		DigitStore & operator = (const vector<int> &d);	//replaces the digits, never copies the old ones
+		DigitStore & operator = (vector<int> &&d);
+
+		//-----------------------------------
+		//Read access, never copies
+		//-----------------------------------
+		const vector<int> & read() const { return block ? block->digits : emptyDigits(); }
+		operator const vector<int> & () const { return read(); }
+		size_t size() const { return read().size(); }
+		bool empty() const { return read().empty(); }
+		const int & operator [] (size_t i) const { return read()[i]; }
+		const int & back() const { return read().back(); }
+		const int * data() const { return read().data(); }
+		const_iterator begin() const { return read().begin(); }
+		const_iterator end() const { return read().end(); }
+		bool operator == (const DigitStore &d) const { return block == d.block || read() == d.read(); }
+		bool operator != (const DigitStore &d) const { return !(*this == d); }
+		long use_count() const;			//number of BigInts sharing the block
+
+		//-----------------------------------
+		//Write access, detaches a shared block first
+		//-----------------------------------
+		vector<int> & write() { if(!block || block->refs.load(memory_order_acquire) != 1) detach(); return block->digits; }
+		void push_back(int d) { write().push_back(d); }
+		void pop_back() { write().pop_back(); }
+		void resize(size_t n, int d = 0) { write().resize(n, d); }
+		void assign(size_t n, int d) { replace().assign(n, d); }
+		void assign(const_iterator first, const_iterator last);
+		void insert(const_iterator pos, int d);
+		void insert(const_iterator pos, size_t n, int d);
+		void erase(const_iterator first, const_iterator last);
+		void clear();
+		void swap(vector<int> &d) { write().swap(d); }
+
+	private:
+		struct Block {
+			atomic<long> refs;
+			vector<int> digits;
+		};
+		Block *block;			//null while empty
+		void detach();
+		vector<int> & replace();
+		void unshare();
+		static const vector<int> & emptyDigits();
+};
+
 //===================================
 //BigInt class definition
 //===================================
@@ -15,8 +92,17 @@ class BigInt {
 		BigInt();				//create BigInt with base 10
 		BigInt(int setbase);			//create BigInt with a certain base
 		BigInt(int input,int base);		//create BigInt from int (base 10) to a certain base
+		BigInt(long input,int base);		//create BigInt from the other native integer widths
+		BigInt(long long input,int base);
+		BigInt(unsigned int input,int base);
+		BigInt(unsigned long input,int base);
+		BigInt(unsigned long long input,int base);
+		BigInt(__int128 input,int base);
+		BigInt(unsigned __int128 input,int base);
+		BigInt(double input,int base);		//create BigInt from double, truncated toward zero
 		BigInt(const string &s,int base);	//create BigInt from string
 		BigInt(const BigInt &b);	  	//create BigInt from another BigInt (copy constructor)
+		BigInt(const BigInt &b, int newbase);	//create BigInt from another BigInt in a different base
 		~BigInt();				//destructor
     BigInt & operator = (const BigInt &b);		//assignment or copy
   
@@ -24,12 +110,47 @@ class BigInt {
 		//Comparison
 		//-----------------------------------
 		int compare(const BigInt &b) const;
+		template<class T> typename enable_if<is_integral<T>::value, int>::type compare(T b) const{
+			return compareSmall(nativeMagnitude(b), nativeNegative(b));
+		}
 
 		//-----------------------------------
 		//Display
 		//-----------------------------------
-		string to_string();
+		string to_string() const;
 		int to_int() const;
+		int get_base() const;
+		size_t size() const;			//number of digits, 1 for zero
+
+		//-----------------------------------
+		//Base conversion
+		//	Power-related bases (2, 4, 8, 16, 32) regroup digits in
+		//	linear time; others convert divide and conquer.
+		//	With auto_convert on, an operand in another base is
+		//	converted to the left operand's base instead of throwing
+		//	DiffBaseException (MappedBigInt still requires equal bases).
+		//-----------------------------------
+		const BigInt & change_base(int newbase);	//convert in place
+		static void set_auto_convert(bool enable);	//off by default
+		static bool auto_convert();
+
+		//-----------------------------------
+		//Native conversions
+		//	Exact; throw NativeOverflowException if the value does not fit
+		//-----------------------------------
+		int64_t to_int64() const;
+		uint64_t to_uint64() const;
+		__int128 to_int128() const;
+		double to_double() const;		//correctly rounded (round half to even)
+		template<class T> bool fits_in() const{
+			if(is_floating_point<T>::value){
+				return fitsFloating(numeric_limits<T>::digits, numeric_limits<T>::max_exponent);
+			}
+			return fitsBits(sizeof(T) * 8, T(-1) < T(0));
+		}
+		bool is_zero() const;
+		bool is_one() const;
+		int sign() const;			//-1, 0 or 1
   
     //-----------------------------------
 		//Arithmetic operations
@@ -41,15 +162,87 @@ class BigInt {
 		const BigInt & operator /= (const BigInt &b);	//division assignment
 		const BigInt & operator %= (const BigInt &b);	//modulus assignment
     //-----------------------------------
+		const BigInt & square();			//square assignment
 		const BigInt & exponentiation(const BigInt &b);	//exponentiation assignment
 		const BigInt & modulusExp(const BigInt &b, const BigInt &mod);//mod exponentiation assignment
 
+    //-----------------------------------
+		//Arithmetic with native integers
+		//	Single digit-vector pass in place, no BigInt temporaries
+		//-----------------------------------
+		template<class T> typename enable_if<is_integral<T>::value, const BigInt &>::type operator += (T b){
+			return addSmall(nativeMagnitude(b), nativeNegative(b));
+		}
+		template<class T> typename enable_if<is_integral<T>::value, const BigInt &>::type operator -= (T b){
+			return addSmall(nativeMagnitude(b), !nativeNegative(b));
+		}
+		template<class T> typename enable_if<is_integral<T>::value, const BigInt &>::type operator *= (T b){
+			return mulSmall(nativeMagnitude(b), nativeNegative(b));
+		}
+		template<class T> typename enable_if<is_integral<T>::value, const BigInt &>::type operator /= (T b){
+			return divSmall(nativeMagnitude(b), nativeNegative(b));
+		}
+		template<class T> typename enable_if<is_integral<T>::value, const BigInt &>::type operator %= (T b){
+			return modSmall(nativeMagnitude(b));
+		}
+
+    //-----------------------------------
+		//Bitwise operations
+		//	Negative values behave as infinite two's complement
+		//-----------------------------------
+		const BigInt & operator <<= (size_t shift);	//left shift assignment (multiply by 2^shift)
+		const BigInt & operator >>= (size_t shift);	//right shift assignment (floor divide by 2^shift)
+		const BigInt & operator &= (const BigInt &b);	//bitwise and assignment
+		const BigInt & operator |= (const BigInt &b);	//bitwise or assignment
+		const BigInt & operator ^= (const BigInt &b);	//bitwise xor assignment
+		BigInt operator ~ () const;			//bitwise not (-x - 1)
+		size_t bit_length() const;			//number of bits in |x|, 0 for zero
+		size_t popcount() const;			//number of set bits in |x|
+		bool test_bit(size_t n) const;			//bit n of the two's complement form
+
 	private:
-		vector<int> vec;		//vector to hold digits
+		DigitStore vec;			//copy-on-write digits
 		int base;			//any base between 2 and 36
 		bool isPositive;	  	//true if positive, false if negative.
 		//main function for division and modulus (private)
 		void divisionMain(const BigInt &b, BigInt &quotient, BigInt &remainder);
+		//Newton reciprocal and the division built on it (private)
+		BigInt reciprocal() const;
+		void divisionNewton(const BigInt &b, BigInt &quotient, BigInt &remainder) const;
+		//main function for the and/or/xor operators (private)
+		void bitwiseMain(const BigInt &b, int op);
+		//native conversion helpers (private)
+		void setNative(unsigned __int128 mag, bool negative);
+		bool magnitude128(unsigned __int128 &out) const;
+		bool fitsBits(int bits, bool isSigned) const;
+		bool fitsFloating(int digits, int maxExponent) const;
+		//kernels for the native integer operators (private)
+		int compareSmall(uint64_t mag, bool negative) const;
+		const BigInt & addSmall(uint64_t mag, bool negative);
+		const BigInt & mulSmall(uint64_t mag, bool negative);
+		const BigInt & divSmall(uint64_t mag, bool negative);
+		const BigInt & modSmall(uint64_t mag);
+		template<class T> static uint64_t nativeMagnitude(T b){
+			if(nativeNegative(b)){
+				return 0 - (uint64_t)b;
+			}
+			return (uint64_t)b;
+		}
+		template<class T> static bool nativeNegative(T b){
+			return is_signed<T>::value && b < T(0);
+		}
+		friend class BigIntAccumulator;
+		friend class FixedBaseExp;
+		friend BigInt multi_modPow(const vector<BigInt> &bases, const vector<BigInt> &exponents, const BigInt &m);
+		friend pair<BigInt, BigInt> divmod(const BigInt &a, const BigInt &b);
+		friend BigInt divexact(const BigInt &a, const BigInt &b);
+		friend bool is_probable_prime(const BigInt &n, int rounds, bool lucas);
+		friend class RnsBigInt;
+		friend class MappedBigInt;
+		friend BigInt from_words(const vector<uint32_t> &words, int base);
+		friend BigInt random_below(const BigInt &bound, const function<void(uint32_t *, size_t)> &source);
+		friend class BigIntView;
+		friend class BigIntArray;
 };
 
 //===================================
@@ -60,8 +253,76 @@ BigInt operator - (const BigInt &a, const BigInt &b);
 BigInt operator * (const BigInt &a, const BigInt &b);
 BigInt operator / (const BigInt &a, const BigInt &b);
 BigInt operator % (const BigInt &a, const BigInt &b);
+pair<BigInt, BigInt> divmod(const BigInt &a, const BigInt &b);	//(a / b, a % b) from one division
+BigInt divexact(const BigInt &a, const BigInt &b);		//a / b when b is known to divide a
+BigInt square(const BigInt &a);
 BigInt pow(const BigInt &a, const BigInt &b);
 BigInt modPow(const BigInt &a, const BigInt &b, const BigInt &m);
+BigInt multi_modPow(const vector<BigInt> &bases, const vector<BigInt> &exponents, const BigInt &m);
+//---- Product and remainder trees ----
+BigInt gcd(const BigInt &a, const BigInt &b);					//non-negative gcd
+vector<vector<BigInt> > product_tree(const vector<BigInt> &values);		//levels, leaves first, root last
+vector<BigInt> remainder_tree(const BigInt &n, const vector<BigInt> &moduli);	//n % moduli[i] for every i
+vector<BigInt> batch_gcd(const vector<BigInt> &values);			//gcd(values[i], product of the others)
+//---- Primality ----
+bool is_probable_prime(const BigInt &n, int rounds = 25, bool lucas = true);	//trial division, Miller-Rabin, strong Lucas (BPSW)
+BigInt next_prime(const BigInt &n, int rounds = 25, unsigned threads = 1);	//smallest probable prime > n
+BigInt operator << (const BigInt &a, size_t shift);
+BigInt operator >> (const BigInt &a, size_t shift);
+BigInt operator & (const BigInt &a, const BigInt &b);
+BigInt operator | (const BigInt &a, const BigInt &b);
+BigInt operator ^ (const BigInt &a, const BigInt &b);
+//---- Native integer operands ----
+template<class T> typename enable_if<is_integral<T>::value, BigInt>::type operator + (const BigInt &a, T b){
+	BigInt c(a);
+	c += b;
+	return c;
+}
+template<class T> typename enable_if<is_integral<T>::value, BigInt>::type operator + (T a, const BigInt &b){
+	BigInt c(b);
+	c += a;
+	return c;
+}
+template<class T> typename enable_if<is_integral<T>::value, BigInt>::type operator - (const BigInt &a, T b){
+	BigInt c(a);
+	c -= b;
+	return c;
+}
+template<class T> typename enable_if<is_integral<T>::value, BigInt>::type operator - (T a, const BigInt &b){
+	BigInt c(a, b.get_base());
+	c -= b;
+	return c;
+}
+template<class T> typename enable_if<is_integral<T>::value, BigInt>::type operator * (const BigInt &a, T b){
+	BigInt c(a);
+	c *= b;
+	return c;
+}
+template<class T> typename enable_if<is_integral<T>::value, BigInt>::type operator * (T a, const BigInt &b){
+	BigInt c(b);
+	c *= a;
+	return c;
+}
+template<class T> typename enable_if<is_integral<T>::value, BigInt>::type operator / (const BigInt &a, T b){
+	BigInt c(a);
+	c /= b;
+	return c;
+}
+template<class T> typename enable_if<is_integral<T>::value, BigInt>::type operator / (T a, const BigInt &b){
+	BigInt c(a, b.get_base());
+	c /= b;
+	return c;
+}
+template<class T> typename enable_if<is_integral<T>::value, BigInt>::type operator % (const BigInt &a, T b){
+	BigInt c(a);
+	c %= b;
+	return c;
+}
+template<class T> typename enable_if<is_integral<T>::value, BigInt>::type operator % (T a, const BigInt &b){
+	BigInt c(a, b.get_base());
+	c %= b;
+	return c;
+}
 //---- Equality Check ---- 
 bool operator == (const BigInt &a, const BigInt &b);
 bool operator != (const BigInt &a, const BigInt &b);
@@ -69,8 +330,373 @@ bool operator <= (const BigInt &a, const BigInt &b);
 bool operator >= (const BigInt &a, const BigInt &b);
 bool operator < (const BigInt &a, const BigInt &b);
 bool operator > (const BigInt &a, const BigInt &b);
+template<class T> typename enable_if<is_integral<T>::value, bool>::type operator == (const BigInt &a, T b){ return a.compare(b) == 0; }
+template<class T> typename enable_if<is_integral<T>::value, bool>::type operator != (const BigInt &a, T b){ return a.compare(b) != 0; }
+template<class T> typename enable_if<is_integral<T>::value, bool>::type operator <= (const BigInt &a, T b){ return a.compare(b) <= 0; }
+template<class T> typename enable_if<is_integral<T>::value, bool>::type operator >= (const BigInt &a, T b){ return a.compare(b) >= 0; }
+template<class T> typename enable_if<is_integral<T>::value, bool>::type operator < (const BigInt &a, T b){ return a.compare(b) < 0; }
+template<class T> typename enable_if<is_integral<T>::value, bool>::type operator > (const BigInt &a, T b){ return a.compare(b) > 0; }
+template<class T> typename enable_if<is_integral<T>::value, bool>::type operator == (T a, const BigInt &b){ return b.compare(a) == 0; }
+template<class T> typename enable_if<is_integral<T>::value, bool>::type operator != (T a, const BigInt &b){ return b.compare(a) != 0; }
+template<class T> typename enable_if<is_integral<T>::value, bool>::type operator <= (T a, const BigInt &b){ return b.compare(a) >= 0; }
+template<class T> typename enable_if<is_integral<T>::value, bool>::type operator >= (T a, const BigInt &b){ return b.compare(a) <= 0; }
+template<class T> typename enable_if<is_integral<T>::value, bool>::type operator < (T a, const BigInt &b){ return b.compare(a) > 0; }
+template<class T> typename enable_if<is_integral<T>::value, bool>::type operator > (T a, const BigInt &b){ return b.compare(a) < 0; }
 
 
+//===================================
+//Random BigInts
+//	Values are drawn as 32-bit words straight from the generator and
+//	converted to the target base in one pass, so any standard engine
+//	works. CounterRng is a fast counter-based generator: output n of
+//	a stream depends only on (seed, stream, n), which lets the bulk
+//	random_fill give every element its own stream and produce the
+//	same values whatever the thread count.
+//===================================
+class CounterRng {
+
+	public:
+		typedef uint64_t result_type;
+		explicit CounterRng(uint64_t seed = 0, uint64_t stream = 0);
+		static constexpr result_type min(){ return 0; }
+		static constexpr result_type max(){ return UINT64_MAX; }
+		result_type operator () (){
+			//SplitMix64 finalizer over key + counter * gamma
+			uint64_t z = key + ++counter * gamma;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			return z ^ (z >> 31);
+		}
+		void discard(uint64_t n){ counter += n; }	//skip n outputs
+
+	private:
+		uint64_t key;			//mixed seed
+		uint64_t gamma;			//odd step, one per stream
+		uint64_t counter;		//outputs drawn so far
+};
+
+BigInt from_words(const vector<uint32_t> &words, int base = 10);	//non-negative value of 32-bit words, least significant first
+
+//fill n words from rng, using every bit of each draw when the engine
+//covers a full 32- or 64-bit range
+template<class URBG> void random_words(uint32_t *w, size_t n, URBG &rng){
+	if(URBG::min() == 0 && (uint64_t)URBG::max() == UINT64_MAX){
+		size_t i = 0;
+		for(; i + 1 < n; i += 2){
+			uint64_t r = rng();
+			w[i] = (uint32_t)r;
+			w[i+1] = (uint32_t)(r >> 32);
+		}
+		if(i < n){
+			w[i] = (uint32_t)rng();
+		}
+	}
+	else if(URBG::min() == 0 && (uint64_t)URBG::max() == UINT32_MAX){
+		for(size_t i = 0; i < n; i++){
+			w[i] = (uint32_t)rng();
+		}
+	}
+	else{
+		uniform_int_distribution<uint32_t> word;
+		for(size_t i = 0; i < n; i++){
+			w[i] = word(rng);
+		}
+	}
+}
+
+//uniform in [0, 2^bits)
+template<class URBG> BigInt random_bits(size_t bits, URBG &rng, int base = 10){
+	vector<uint32_t> words((bits + 31) / 32);
+	random_words(words.data(), words.size(), rng);
+	if(bits % 32 != 0){
+		words.back() &= ((uint32_t)1 << (bits % 32)) - 1;
+	}
+	return from_words(words, base);
+}
+
+//uniform in [0, bound) in bound's base, bound > 0; rejection sampling
+//with no modulo bias
+typedef function<void(uint32_t *, size_t)> WordSource;		//fills n random words
+BigInt random_below(const BigInt &bound, const WordSource &source);
+template<class URBG> BigInt random_below(const BigInt &bound, URBG &rng){
+	return random_below(bound, WordSource([&rng](uint32_t *w, size_t n){ random_words(w, n, rng); }));
+}
+
+//bulk forms: out[i] is drawn from CounterRng(seed, i), threads = 0 uses
+//every hardware thread
+void random_fill(vector<BigInt> &out, size_t bits, uint64_t seed, int base = 10, unsigned threads = 0);
+void random_fill(vector<BigInt> &out, const BigInt &bound, uint64_t seed, unsigned threads = 0);
+
+//===================================
+//Random probable prime of exactly bits bits (bits >= 2)
+//	Draw a candidate with the top bit set and take the next prime,
+//	starting over if that runs past bits bits.
+//===================================
+template<class URBG> BigInt random_prime(size_t bits, URBG &rng, int base = 10, int rounds = 25, unsigned threads = 1){
+	while(true){
+		BigInt candidate = random_bits(bits - 1, rng, base);
+		candidate += BigInt(1, base) << (bits - 1);
+		BigInt p = next_prime(candidate - 1, rounds, threads);
+		if(p.bit_length() == bits){
+			return p;
+		}
+	}
+}
+
+//===================================
+//BigIntAccumulator class definition
+//	Running sum of many BigInts. Terms are added digit by digit into
+//	wide limbs and carries are only resolved when the value is read
+//	or a limb could overflow.
+//===================================
+class BigIntAccumulator {
+
+	public:
+		BigIntAccumulator();				//accumulate in base 10
+		BigIntAccumulator(int setbase);			//accumulate in a certain base
+		BigIntAccumulator & operator += (const BigInt &b);	//add a term
+		BigIntAccumulator & operator -= (const BigInt &b);	//subtract a term
+		void add_product(const BigInt &a, const BigInt &b);	//add a * b
+		BigInt value();					//resolve carries and return the sum
+		void clear();					//reset the sum to zero
+
+	private:
+		vector<int64_t> limbs;		//unnormalized digits, least significant first
+		int base;			//any base between 2 and 36
+		int64_t load;			//bound on |limb| since the last normalize
+		void addDigits(const BigInt &b, bool negative);
+		void reserve(int64_t extra, size_t size);
+		void normalize();
+};
+
+//===================================
+//FixedBaseExp class definition
+//	g^e mod m for one fixed g and m and many exponents e.
+//	The table holds g^(d * 2^(window*i)) mod m for every window
+//	position i and window value d, so pow(e) costs one modular
+//	multiplication per nonzero window of e and no squarings.
+//	Memory: ceil(maxBits/window) * (2^window - 1) residues.
+//	Per call: ceil(maxBits/window) multiplications at most.
+//===================================
+class FixedBaseExp {
+
+	public:
+		FixedBaseExp(const BigInt &g, const BigInt &m, size_t maxBits, int window = 4);
+		BigInt pow(const BigInt &e) const;	//g^e mod m, in [0, m)
+		size_t table_size() const;		//number of residues stored
+
+	private:
+		vector<BigInt> table;		//table[i*(2^window-1) + d-1] = g^(d*2^(window*i)) mod m
+		BigInt mod;			//the modulus m
+		BigInt top;			//g^(2^(window*windows)) mod m, for exponents past maxBits
+		int window;			//bits per window, between 1 and 16
+		size_t windows;			//number of window positions in the table
+};
+
+//===================================
+//RnsBigInt class definition
+//	Value held as residues modulo a set of word-size primes (a residue
+//	number system). +, - and * run residue by residue with no carries,
+//	each loop independent across primes. Converting back uses the
+//	Chinese remainder theorem (Garner's mixed radix form).
+//	The capacity in bits picks how many primes are used; every result
+//	must stay within +-2^capacity to convert back correctly.
+//===================================
+struct RnsBasis;
+
+class RnsBigInt {
+
+	public:
+		RnsBigInt(size_t capacityBits, int setbase = 10);	//zero
+		RnsBigInt(const BigInt &b, size_t capacityBits);	//residues of b
+		BigInt to_bigint() const;				//CRT reconstruction in the original base
+		size_t moduli() const;					//number of primes in use
+
+		const RnsBigInt & operator += (const RnsBigInt &b);
+		const RnsBigInt & operator -= (const RnsBigInt &b);
+		const RnsBigInt & operator *= (const RnsBigInt &b);
+		bool operator == (const RnsBigInt &b) const;
+		bool operator != (const RnsBigInt &b) const;
+
+	private:
+		shared_ptr<const RnsBasis> basis;	//primes and CRT constants, shared per capacity
+		vector<uint32_t> residues;		//residues[i] = value mod basis->primes[i]
+		int base;				//base of the BigInt handed back by to_bigint
+		void checkBasis(const RnsBigInt &b) const;
+};
+
+RnsBigInt operator + (const RnsBigInt &a, const RnsBigInt &b);
+RnsBigInt operator - (const RnsBigInt &a, const RnsBigInt &b);
+RnsBigInt operator * (const RnsBigInt &a, const RnsBigInt &b);
+
+//===================================
+//MappedBigInt class definition
+//	A BigInt whose digits live in a memory-mapped file, one byte per
+//	digit, for values too large to hold in RAM. The arithmetic streams
+//	through the digits in blocks and drops every finished block from
+//	memory, so the resident set stays near working_set() bytes no
+//	matter how long the operands are.
+//	The file keeps the base, sign and length in its first page and can
+//	be reopened later.
+//===================================
+class MappedBigInt {
+
+	public:
+		MappedBigInt(const string &path, int setbase);		//create a zero in a new file
+		MappedBigInt(const string &path, const BigInt &b);	//create a copy of b in a new file
+		explicit MappedBigInt(const string &path);		//open an existing file
+		~MappedBigInt();
+		MappedBigInt(const MappedBigInt &b) = delete;
+		MappedBigInt & operator = (const MappedBigInt &b) = delete;
+
+		BigInt to_bigint() const;		//load the whole value into memory
+		size_t size() const;			//number of digits
+		bool is_negative() const;
+		int get_base() const;
+
+		static void set_working_set(size_t bytes);	//memory budget for the out-of-core operations
+		static size_t working_set();
+
+		//out = a + b, a - b, a * b. add/subtract may write over a or b.
+		static void add(const MappedBigInt &a, const MappedBigInt &b, MappedBigInt &out);
+		static void subtract(const MappedBigInt &a, const MappedBigInt &b, MappedBigInt &out);
+		static void multiply(const MappedBigInt &a, const MappedBigInt &b, MappedBigInt &out);
+
+	private:
+		string path;			//backing file
+		int fd;				//open descriptor of the file
+		unsigned char *map;		//whole mapping: header page, then digits
+		size_t mapped;			//bytes currently mapped
+		void openFile(int flags);
+		void closeFile();
+		void reserve(size_t digits);
+		unsigned char *digits() const;
+		void setLength(size_t length);
+		void setNegative(bool negative);
+		void release(size_t from, size_t to) const;
+		static void addMagnitudes(const MappedBigInt &a, const MappedBigInt &b, MappedBigInt &out);
+		static void subMagnitudes(const MappedBigInt &a, const MappedBigInt &b, MappedBigInt &out);
+		static int compareMagnitudes(const MappedBigInt &a, const MappedBigInt &b);
+		static void addSigned(const MappedBigInt &a, const MappedBigInt &b, bool negateB, MappedBigInt &out);
+};
+
+//===================================
+//BigIntArray class definition
+//	Many BigInts of one base packed into a single buffer, one byte per
+//	digit and most significant digit first, with side tables holding
+//	each element's offset, length and sign. Elements are read through
+//	BigIntView, which points into the buffer and is invalidated by any
+//	change to the array.
+//===================================
+class BigIntView {
+
+	public:
+		size_t size() const;			//number of digits
+		bool is_negative() const;
+		int compare(const BigIntView &b) const;	//-1, 0 or 1
+		BigInt to_bigint() const;
+
+	private:
+		const unsigned char *digits;		//most significant first
+		size_t length;
+		bool negative;
+		int base;
+		BigIntView(const unsigned char *d, size_t n, bool neg, int setbase);
+		friend class BigIntArray;
+};
+
+class BigIntArray {
+
+	public:
+		explicit BigIntArray(int setbase = 10);
+		BigIntArray(const vector<BigInt> &values, int setbase);
+
+		void push_back(const BigInt &b);		//append
+		void reserve(size_t count, size_t totalDigits);
+		void clear();
+		size_t size() const;
+		bool empty() const;
+		int get_base() const;
+
+		BigIntView operator [] (size_t i) const;	//view into the buffer
+		BigInt get(size_t i) const;
+		void set(size_t i, const BigInt &b);
+
+		//elementwise, in place
+		BigIntArray & operator += (const BigInt &b);
+		BigIntArray & operator -= (const BigInt &b);
+		BigIntArray & operator *= (const BigInt &b);
+		BigIntArray & operator %= (const BigInt &b);
+		BigIntArray & operator += (const BigIntArray &b);
+		BigIntArray & operator -= (const BigIntArray &b);
+		BigIntArray & operator *= (const BigIntArray &b);
+
+		void sort();			//ascending by value
+		void compact();			//release space left by elements that grew
+
+	private:
+		vector<unsigned char> digits;	//every element's digits, back to back
+		vector<uint64_t> offsets;	//start of each element in digits
+		vector<uint64_t> lengths;	//digits in each element
+		vector<unsigned char> negative;	//sign of each element
+		int base;
+		size_t garbage;			//bytes of digits no element uses
+		void load(size_t i, BigInt &out) const;
+		void store(size_t i, const BigInt &b);
+		void apply(const BigInt &b, int op);
+		void applyArray(const BigIntArray &b, int op);
+};
+
+//===================================
+//Asynchronous execution
+//	The *_async functions run on an executor and hand back a future.
+//	The long loops (exponent bits, Karatsuba levels, long division
+//	steps) check the token between steps and throw
+//	OperationCancelledException into the future once it is cancelled.
+//	The progress callback gets the fraction done, from 0 to 1, on the
+//	executor's thread.
+//===================================
+class CancellationToken {
+
+	public:
+		CancellationToken();			//a token that has not been cancelled
+		void cancel();				//ask every holder of a copy to stop
+		bool cancelled() const;
+
+	private:
+		shared_ptr< atomic<bool> > flag;	//shared by every copy of the token
+};
+
+typedef function<void(double)> ProgressCallback;		//fraction done, 0 to 1
+typedef function<void(function<void()>)> Executor;		//runs a task; empty means a new detached thread
+
+future<BigInt> mul_async(const BigInt &a, const BigInt &b, CancellationToken token = CancellationToken(), ProgressCallback progress = ProgressCallback(), Executor executor = Executor());
+future<BigInt> pow_async(const BigInt &a, const BigInt &b, CancellationToken token = CancellationToken(), ProgressCallback progress = ProgressCallback(), Executor executor = Executor());
+future<BigInt> modPow_async(const BigInt &a, const BigInt &b, const BigInt &m, CancellationToken token = CancellationToken(), ProgressCallback progress = ProgressCallback(), Executor executor = Executor());
+future<string> to_string_async(const BigInt &a, CancellationToken token = CancellationToken(), ProgressCallback progress = ProgressCallback(), Executor executor = Executor());
+
+//===================================
+//Parallel reductions
+//	The range is split into one chunk per hardware thread, balanced by
+//	digit count, and each chunk runs as a task on the executor (or its
+//	own thread). Products are taken smallest-pair-first inside a chunk
+//	and the chunk results are then multiplied pairwise, so operands
+//	stay close in size. An empty range sums to 0 and multiplies to 1
+//	(base 10); parallel_minmax throws EmptyRangeException.
+//===================================
+BigInt parallel_sum(const vector<BigInt> &values, Executor executor = Executor());
+BigInt parallel_product(const vector<BigInt> &values, Executor executor = Executor());
+pair<BigInt, BigInt> parallel_minmax(const vector<BigInt> &values, Executor executor = Executor());	//(min, max)
+template<class It> BigInt parallel_sum(It first, It last, Executor executor = Executor()){
+	return parallel_sum(vector<BigInt>(first, last), executor);
+}
+template<class It> BigInt parallel_product(It first, It last, Executor executor = Executor()){
+	return parallel_product(vector<BigInt>(first, last), executor);
+}
+template<class It> pair<BigInt, BigInt> parallel_minmax(It first, It last, Executor executor = Executor()){
+	return parallel_minmax(vector<BigInt>(first, last), executor);
+}
+
 //===================================
 //Custom Exceptions
 //	to handle math function errors
@@ -98,3 +724,57 @@ struct InvalidBaseException : exception{
     	return "Error: Base should be between 2 and 36";
     }
 };
+
+struct NativeOverflowException : exception{
+	const char * what () const throw (){
+    	return "Error: Value does not fit in the native type";
+    }
+};
+
+struct InvalidDoubleException : exception{
+	const char * what () const throw (){
+    	return "Error: Cannot convert NaN or infinity";
+    }
+};
+
+struct InvalidWindowException : exception{
+	const char * what () const throw (){
+    	return "Error: Window should be between 1 and 16 bits";
+    }
+};
+
+struct SizeMismatchException : exception{
+	const char * what () const throw (){
+    	return "Error: Operands have different lengths";
+    }
+};
+
+struct DiffRnsBasisException : exception{
+	const char * what () const throw (){
+    	return "Error: RNS values use different moduli";
+    }
+};
+
+struct OperationCancelledException : exception{
+	const char * what () const throw (){
+    	return "Error: Operation cancelled";
+    }
+};
+
+struct InvalidBoundException : exception{
+	const char * what () const throw (){
+    	return "Error: Bound should be positive";
+    }
+};
+
+struct EmptyRangeException : exception{
+	const char * what () const throw (){
+    	return "Error: Range is empty";
+    }
+};
+
+struct MappedFileException : exception{
+	const char * what () const throw (){
+    	return "Error: Memory-mapped file operation failed";
+    }
+};